@@ -87,6 +87,7 @@ HEADERS += \
 	src/db/breadcrumbs.h \
 	src/db/column.h \
 	src/db/database.h \
+	src/db/db_copy_thread.h \
 	src/db/db_data_type.h \
 	src/db/db_error.h \
 	src/db/db_upgrade.h \
@@ -190,6 +191,7 @@ SOURCES += \
 	src/db/breadcrumbs.cpp \
 	src/db/column.cpp \
 	src/db/database.cpp \
+	src/db/db_copy_thread.cpp \
 	src/db/db_error.cpp \
 	src/db/db_upgrade.cpp \
 	src/db/normal_table.cpp \
@@ -45,16 +45,26 @@ TableChangeListenerCompositeTable::~TableChangeListenerCompositeTable()
 
 
 
+/**
+ * This method is called before data in the database is changed.
+ * 
+ * Waits for the owner's background computations to finish, since they read the database.
+ */
+void TableChangeListenerCompositeTable::dataAboutToChange() const
+{
+	owner.waitForBackgroundUpdate();
+}
+
 /**
  * This method is called after any data in the database was changed.
  *
  * @param affectedColumns				The columns whose data has been changed.
  * @param rowsAddedOrRemovedPerTable	The rows that have been added or removed from the table. The bool indicates whether the row was added (true) or removed (false).
+ * @param changedRowsPerColumn			The rows in which existing cells have been changed, for each affected column.
  */
-void TableChangeListenerCompositeTable::dataChanged(const QSet<const Column*>& affectedColumns, const QHash<const Table*, QList<QPair<BufferRowIndex, bool>>>& rowsAddedOrRemovedPerTable) const
+void TableChangeListenerCompositeTable::dataChanged(const QSet<const Column*>& affectedColumns, const QHash<const Table*, QList<QPair<BufferRowIndex, bool>>>& rowsAddedOrRemovedPerTable, const QHash<const Column*, QSet<BufferRowIndex>>& changedRowsPerColumn) const
 {
 	if (affectedColumns.isEmpty() && rowsAddedOrRemovedPerTable.isEmpty()) return;
 	
-	const QList<QPair<BufferRowIndex, bool>>& rowsAddedOrRemoved = rowsAddedOrRemovedPerTable.value(&owner.baseTable);
-	owner.announceChanges(affectedColumns, rowsAddedOrRemoved);
+	owner.announceChanges(affectedColumns, rowsAddedOrRemovedPerTable, changedRowsPerColumn);
 }
@@ -38,7 +38,8 @@ public:
 	TableChangeListenerCompositeTable(CompositeTable& owner);
 	virtual ~TableChangeListenerCompositeTable();
 	
-	virtual void dataChanged(const QSet<const Column*>& affectedColumns, const QHash<const Table*, QList<QPair<BufferRowIndex, bool>>>& rowsAddedOrRemovedPerTable) const;
+	virtual void dataAboutToChange() const;
+	virtual void dataChanged(const QSet<const Column*>& affectedColumns, const QHash<const Table*, QList<QPair<BufferRowIndex, bool>>>& rowsAddedOrRemovedPerTable, const QHash<const Column*, QSet<BufferRowIndex>>& changedRowsPerColumn) const;
 };
 
 
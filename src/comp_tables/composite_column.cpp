@@ -191,6 +191,37 @@ QSet<ValidItemID> CompositeColumn::computeIDsAt(BufferRowIndex rowIndex) const
 	return { VALID_ITEM_ID(table.baseTable.primaryKeyColumn.getValueAt(rowIndex)) };
 }
 
+/**
+ * Returns the table whose IDs computeIDsAt() returns.
+ * 
+ * By default, this is the base table.
+ * 
+ * @return	The table containing the items whose IDs are associated with the rows of this column.
+ */
+const NormalTable& CompositeColumn::getIDTable() const
+{
+	return table.baseTable;
+}
+
+/**
+ * For each of the given rows, finds the rows in the ID table (see getIDTable()) whose IDs
+ * computeIDsAt() would return, without reading any IDs.
+ * 
+ * By default, every row is mapped to itself in the base table.
+ * 
+ * @param rowIndices	The buffer row indices in the base table.
+ * @return				The mapping from each given row to the associated rows in the ID table.
+ */
+BreadcrumbMapping CompositeColumn::mapRowsToIDTable(const QList<BufferRowIndex>& rowIndices) const
+{
+	QList<int> offsets = QList<int>();
+	offsets.reserve(rowIndices.size() + 1);
+	for (int i = 0; i <= rowIndices.size(); i++) {
+		offsets.append(i);
+	}
+	return BreadcrumbMapping(offsets, rowIndices);
+}
+
 
 
 /**
@@ -209,6 +240,68 @@ QList<QVariant> CompositeColumn::computeWholeColumn() const
 	return cells;
 }
 
+/**
+ * Indicates whether the buffer contents for this column should be computed all at once using
+ * computeWholeColumn() rather than cell by cell using computeValueAt().
+ * 
+ * This is always the case for columns with interdependent cells, but subclasses can also opt in
+ * if computing the whole column together is faster.
+ * 
+ * @return	True if the column should be computed as a whole, false otherwise.
+ */
+bool CompositeColumn::isComputedAsWholeColumn() const
+{
+	return cellsAreInterdependent;
+}
+
+/**
+ * Attempts to determine how the cells of this column change after rows in the base table were
+ * added, removed or changed, without computing the whole column again.
+ * 
+ * This is meant for columns with interdependent cells, where single cells cannot simply be
+ * recomputed. Columns which support it update their internal state and report the new values of
+ * all cells which changed. By default, this is not supported.
+ * 
+ * @param rowsAddedOrRemoved	The rows which were added to (true) or removed from (false) the base table, in order.
+ * @param changedRows			The rows of the base table in which values used by this column were changed.
+ * @param changedCells			The map to which the new values of all changed cells are added.
+ * @return						True if the changed cells could be determined, false if the whole column has to be recomputed.
+ */
+bool CompositeColumn::updateIncrementally(const QList<QPair<BufferRowIndex, bool>>& rowsAddedOrRemoved, const QSet<BufferRowIndex>& changedRows, QHash<BufferRowIndex, QVariant>& changedCells) const
+{
+	Q_UNUSED(rowsAddedOrRemoved);
+	Q_UNUSED(changedRows);
+	Q_UNUSED(changedCells);
+	return false;
+}
+
+
+
+/**
+ * Returns the breadcrumb trail used to compute the content of this column, if any.
+ * 
+ * Columns which only use columns from the base table itself have no breadcrumb trail.
+ * 
+ * @return	A pointer to the breadcrumb trail of this column, or nullptr if there is none.
+ */
+const Breadcrumbs* CompositeColumn::getBreadcrumbs() const
+{
+	return nullptr;
+}
+
+/**
+ * Returns the base table column whose contents this column shows unchanged, if any.
+ * 
+ * The cells of such a column are not computed and stored separately, but read directly from the
+ * buffer of the base table.
+ * 
+ * @return	A pointer to the base table column containing the cells of this column, or nullptr if the cells have to be computed.
+ */
+const Column* CompositeColumn::getSharedBaseTableColumn() const
+{
+	return nullptr;
+}
+
 
 
 /**
@@ -233,6 +326,65 @@ QVariant CompositeColumn::getFormattedValueAt(BufferRowIndex rowIndex) const
 	return table.getFormattedValue(rowIndex, *this);
 }
 
+/**
+ * Provides direct read access to the buffered cells of this column as integers, if possible (see
+ * CompositeTable::getIntegerBufferColumn()).
+ * 
+ * @param values	Set to the integer values of all cells in the column, if applicable.
+ * @param nullFlags	Set to the flags marking empty cells in the column, if applicable.
+ * @return			True if the cells can be read directly as integers, false otherwise.
+ */
+bool CompositeColumn::getIntegerCells(const QList<qint32>*& values, const std::vector<bool>*& nullFlags) const
+{
+	return table.getIntegerBufferColumn(*this, values, nullFlags);
+}
+
+/**
+ * Provides direct read access to the buffered cells of this column as bits, if possible (see
+ * CompositeTable::getBitBufferColumn()).
+ * 
+ * @param bits	Set to the values of all cells in the column, if applicable.
+ * @return		True if the cells can be read directly as bits, false otherwise.
+ */
+bool CompositeColumn::getBitCells(const std::vector<bool>*& bits) const
+{
+	return table.getBitBufferColumn(*this, bits);
+}
+
+/**
+ * Provides direct read access to the buffered cells of this column as strings, if possible (see
+ * CompositeTable::getStringBufferColumn()).
+ * 
+ * @param arena		Set to the string arena containing the cells of the column, if applicable.
+ * @param offsets	Set to the offsets of all cells in the string arena, if applicable.
+ * @param lengths	Set to the lengths of all cells in the string arena, if applicable.
+ * @param nullFlags	Set to the flags marking empty cells in the column, if applicable.
+ * @return			True if the cells can be read directly as strings, false otherwise.
+ */
+bool CompositeColumn::getStringCells(const QString*& arena, const QList<qint32>*& offsets, const QList<qint32>*& lengths, const std::vector<bool>*& nullFlags) const
+{
+	return table.getStringBufferColumn(*this, arena, offsets, lengths, nullFlags);
+}
+
+/**
+ * Provides direct read access to the two integer columns from which the dual enum cells of this
+ * column are computed, if there are any.
+ * 
+ * @param discerningValues		Set to the discerning enum values of all rows, if applicable.
+ * @param discerningNullFlags	Set to the flags marking empty discerning enum values, if applicable.
+ * @param displayedValues		Set to the displayed enum values of all rows, if applicable.
+ * @param displayedNullFlags	Set to the flags marking empty displayed enum values, if applicable.
+ * @return						True if the cells can be read as two integer columns, false otherwise.
+ */
+bool CompositeColumn::getDualEnumCells(const QList<qint32>*& discerningValues, const std::vector<bool>*& discerningNullFlags, const QList<qint32>*& displayedValues, const std::vector<bool>*& displayedNullFlags) const
+{
+	Q_UNUSED(discerningValues);
+	Q_UNUSED(discerningNullFlags);
+	Q_UNUSED(displayedValues);
+	Q_UNUSED(displayedNullFlags);
+	return false;
+}
+
 
 
 /**
@@ -256,15 +408,20 @@ QVariant CompositeColumn::replaceEnumIfApplicable(QVariant content) const
 
 
 /**
- * Compares two cells of this column.
+ * Reads the cells of this column at the given rows and converts them to integer sort keys, so that
+ * rows can be sorted by this column without further access to the buffer or the cell values.
  * 
- * @param value1	The first cell's value.
- * @param value2	The second cell's value.
- * @return			True if the first cell's value is smaller than the second cell's value.
+ * @param rowIndices	The buffer row indices of the cells to get sort keys for.
+ * @return				The sort keys for the given rows, in the same order (see computeSortKeys()).
  */
-bool CompositeColumn::compare(const QVariant& value1, const QVariant& value2) const
+QList<qint64> CompositeColumn::getSortKeys(const QList<BufferRowIndex>& rowIndices) const
 {
-	return compareCells(contentType, value1, value2);
+	QList<QVariant> values = QList<QVariant>();
+	values.reserve(rowIndices.size());
+	for (const BufferRowIndex& rowIndex : rowIndices) {
+		values.append(getRawValueAt(rowIndex));
+	}
+	return computeSortKeys(contentType, values);
 }
 
 
@@ -438,6 +595,18 @@ const QSet<const Column*> DirectCompositeColumn::getAllUnderlyingColumns() const
 	return { &contentColumn };
 }
 
+/**
+ * Returns the content column unless the column is bimodal, since the cells of a non-bimodal
+ * column are identical to those of the content column.
+ * 
+ * @return	A pointer to the content column, or nullptr if the column is bimodal or the content column is not in the base table.
+ */
+const Column* DirectCompositeColumn::getSharedBaseTableColumn() const
+{
+	if (bimodal || &contentColumn.table != &table.baseTable) return nullptr;
+	return &contentColumn;
+}
+
 
 
 QStringList DirectCompositeColumn::encodeTypeSpecific() const
@@ -504,6 +673,28 @@ QSet<ValidItemID> ReferenceCompositeColumn::computeIDsAt(BufferRowIndex rowIndex
 	return { VALID_ITEM_ID(breadcrumbs.getTargetTable().primaryKeyColumn.getValueAt(targetRowIndex)) };
 }
 
+/**
+ * Returns the table whose IDs computeIDsAt() returns, which is the target table.
+ * 
+ * @return	The target table of the breadcrumb trail.
+ */
+const NormalTable& ReferenceCompositeColumn::getIDTable() const
+{
+	return breadcrumbs.getTargetTable();
+}
+
+/**
+ * For each of the given rows, finds the row in the target table whose ID computeIDsAt() would
+ * return, if any, by evaluating the breadcrumb trail for all rows at once.
+ * 
+ * @param rowIndices	The buffer row indices in the base table.
+ * @return				The mapping from each given row to the referenced row in the target table.
+ */
+BreadcrumbMapping ReferenceCompositeColumn::mapRowsToIDTable(const QList<BufferRowIndex>& rowIndices) const
+{
+	return breadcrumbs.evaluateForRows(rowIndices, false);
+}
+
 /**
  * Computes the value of the cell at the given row index.
  *
@@ -538,6 +729,16 @@ const QSet<const Column*> ReferenceCompositeColumn::getAllUnderlyingColumns() co
 	return result;
 }
 
+/**
+ * Returns the breadcrumb trail which leads from the base table to the content column.
+ * 
+ * @return	A pointer to the breadcrumb trail of this column.
+ */
+const Breadcrumbs* ReferenceCompositeColumn::getBreadcrumbs() const
+{
+	return &breadcrumbs;
+}
+
 
 
 QStringList ReferenceCompositeColumn::encodeTypeSpecific() const
@@ -697,6 +898,23 @@ QVariant DependentEnumCompositeColumn::computeValueAt(BufferRowIndex rowIndex) c
 	return QVariant(QList<QVariant>({ discerning, displayed }));
 }
 
+/**
+ * Provides direct read access to the discerning and displayed enum columns in the base table
+ * buffer, whose rows correspond to the rows of this column.
+ * 
+ * @param discerningValues		Set to the discerning enum values of all rows.
+ * @param discerningNullFlags	Set to the flags marking empty discerning enum values.
+ * @param displayedValues		Set to the displayed enum values of all rows.
+ * @param displayedNullFlags	Set to the flags marking empty displayed enum values.
+ * @return						True if both base table columns are stored as integers, false otherwise.
+ */
+bool DependentEnumCompositeColumn::getDualEnumCells(const QList<qint32>*& discerningValues, const std::vector<bool>*& discerningNullFlags, const QList<qint32>*& displayedValues, const std::vector<bool>*& displayedNullFlags) const
+{
+	const TableBuffer& baseBuffer = table.baseTable.getBuffer();
+	return baseBuffer.getIntegerColumn(discerningEnumColumn.getIndex(), DualEnum, discerningValues, discerningNullFlags)
+		&& baseBuffer.getIntegerColumn(displayedEnumColumn.getIndex(), DualEnum, displayedValues, displayedNullFlags);
+}
+
 
 
 /**
@@ -735,7 +953,10 @@ QStringList DependentEnumCompositeColumn::encodeTypeSpecific() const
  */
 IndexCompositeColumn::IndexCompositeColumn(CompositeTable& table, QString name, QString uiName, QString suffix, const QList<BaseSortingPass> sortingPasses, bool isOrdinal) :
 	CompositeColumn(isOrdinal ? Ordinal : Index, table, name, uiName, Integer, true, true, suffix),
-	sortingPasses(sortingPasses)
+	sortingPasses(sortingPasses),
+	cachedKeys(QList<QList<SortKey>>()),
+	cachedOrder(QList<BufferRowIndex>()),
+	cacheValid(false)
 {
 	assert(!sortingPasses.isEmpty());
 	for (const auto& [column, order] : sortingPasses) {
@@ -762,49 +983,226 @@ QVariant IndexCompositeColumn::computeValueAt(BufferRowIndex rowIndex) const
 /**
  * Computes the value of all cells in the column together.
  *
- * This is used for columns with interdependent cells, such as the IndexCompositeColumn.
+ * This is used for columns with interdependent cells, such as the IndexCompositeColumn. The index
+ * of every row is found by inverting the sorted order.
  *
  * @return	Computed values for all cells in the column.
  */
 QList<QVariant> IndexCompositeColumn::computeWholeColumn() const
 {
-	QList<BufferRowIndex> order = getRowIndexOrderList();
+	const QList<BufferRowIndex> order = getRowIndexOrderList();
 	
-	QList<QVariant> cells = QList<QVariant>();
-	for (BufferRowIndex rowIndex = BufferRowIndex(0); rowIndex.isValid(order.size()); rowIndex++) {
-		cells.append(order.indexOf(rowIndex) + 1);
+	QList<QVariant> cells = QList<QVariant>(order.size());
+	for (int position = 0; position < order.size(); position++) {
+		cells.replace(order.at(position).get(), position + 1);
 	}
 	
 	return cells;
 }
 
+/**
+ * Updates the cached order after rows in the base table were added, removed or changed, and
+ * reports the new values of all cells which changed as a result.
+ * 
+ * Every added or changed row is (re)inserted into the cached order using binary search, so that
+ * no full sort is necessary. This is not possible if the cache is not up to date, or if rows were
+ * both removed and changed in the same batch (since the changed row indices may refer to the state
+ * before the removal).
+ * 
+ * @param rowsAddedOrRemoved	The rows which were added to (true) or removed from (false) the base table, in order.
+ * @param changedRows			The rows of the base table in which values used by this column were changed.
+ * @param changedCells			The map to which the new values of all changed cells are added.
+ * @return						True if the changed cells could be determined, false if the whole column has to be recomputed.
+ */
+bool IndexCompositeColumn::updateIncrementally(const QList<QPair<BufferRowIndex, bool>>& rowsAddedOrRemoved, const QSet<BufferRowIndex>& changedRows, QHash<BufferRowIndex, QVariant>& changedCells) const
+{
+	if (!cacheValid) return false;
+	
+	int numRowsAdded = 0;
+	int numRowsRemoved = 0;
+	for (const auto& [_, addedNotRemoved] : rowsAddedOrRemoved) {
+		(addedNotRemoved ? numRowsAdded : numRowsRemoved)++;
+	}
+	if (numRowsRemoved > 0 && !changedRows.isEmpty()) return false;
+	if (cachedKeys.size() + numRowsAdded - numRowsRemoved != table.baseTable.getNumberOfRows()) return false;
+	
+	QList<int> touchedPositions = QList<int>();
+	
+	for (const auto& [bufferRowIndex, addedNotRemoved] : rowsAddedOrRemoved) {
+		if (addedNotRemoved) {
+			// Shift buffer indices at or after the new row, then insert it
+			for (BufferRowIndex& orderedIndex : cachedOrder) {
+				if (orderedIndex >= bufferRowIndex) orderedIndex++;
+			}
+			cachedKeys.insert(bufferRowIndex.get(), computeSortKeysFor(bufferRowIndex));
+			const int position = std::lower_bound(cachedOrder.constBegin(), cachedOrder.constEnd(), bufferRowIndex, [this] (BufferRowIndex index1, BufferRowIndex index2) { return isSortedBefore(index1, index2); }) - cachedOrder.constBegin();
+			cachedOrder.insert(position, bufferRowIndex);
+			touchedPositions.append(position);
+		} else {
+			// Remove the row, then shift buffer indices after it
+			const int position = findPositionOf(bufferRowIndex);
+			cachedOrder.removeAt(position);
+			cachedKeys.removeAt(bufferRowIndex.get());
+			for (BufferRowIndex& orderedIndex : cachedOrder) {
+				if (orderedIndex > bufferRowIndex) orderedIndex--;
+			}
+			touchedPositions.append(position);
+		}
+	}
+	
+	for (const BufferRowIndex& bufferRowIndex : changedRows) {
+		// Take the row out using its old keys and put it back in using the new ones
+		const int oldPosition = findPositionOf(bufferRowIndex);
+		cachedOrder.removeAt(oldPosition);
+		cachedKeys.replace(bufferRowIndex.get(), computeSortKeysFor(bufferRowIndex));
+		const int newPosition = std::lower_bound(cachedOrder.constBegin(), cachedOrder.constEnd(), bufferRowIndex, [this] (BufferRowIndex index1, BufferRowIndex index2) { return isSortedBefore(index1, index2); }) - cachedOrder.constBegin();
+		cachedOrder.insert(newPosition, bufferRowIndex);
+		touchedPositions.append(oldPosition);
+		touchedPositions.append(newPosition);
+	}
+	
+	if (touchedPositions.isEmpty() || cachedOrder.isEmpty()) return true;
+	
+	/* Every row which moved stayed within the range between the positions it was taken out of and
+	 * put back in, so all moved rows lie between the first and last touched position. If rows were
+	 * added or removed, all rows after the first touched position have moved. */
+	const int firstPosition = std::min(*std::min_element(touchedPositions.constBegin(), touchedPositions.constEnd()), (int) cachedOrder.size() - 1);
+	int lastPosition = cachedOrder.size() - 1;
+	if (rowsAddedOrRemoved.isEmpty()) {
+		lastPosition = std::min(*std::max_element(touchedPositions.constBegin(), touchedPositions.constEnd()), lastPosition);
+	}
+	
+	collectChangedCells(firstPosition, lastPosition, changedCells);
+	return true;
+}
+
+/**
+ * Adds the new values of all cells which may have changed after rows in the given range of
+ * positions in the cached order moved.
+ * 
+ * @param firstPosition	The first position in the cached order which may have changed.
+ * @param lastPosition	The last position in the cached order which may have changed.
+ * @param changedCells	The map to which the new values of all changed cells are added.
+ */
+void IndexCompositeColumn::collectChangedCells(int firstPosition, int lastPosition, QHash<BufferRowIndex, QVariant>& changedCells) const
+{
+	for (int position = firstPosition; position <= lastPosition; position++) {
+		changedCells.insert(cachedOrder.at(position), position + 1);
+	}
+}
+
+/**
+ * Computes the order of all rows in the base table according to the sorting passes and caches it
+ * along with the sort keys.
+ * 
+ * The sort keys are extracted from the base table once per row, after which all rows are sorted
+ * in a single pass which compares the keys of all sorting passes in turn. Ties are broken by
+ * buffer row index, which gives the same result as a series of stable sorts.
+ * 
+ * @return	All buffer row indices of the base table in sorted order.
+ */
 QList<BufferRowIndex> IndexCompositeColumn::getRowIndexOrderList() const
 {
-	int numberOfRows = sortingPasses.at(0).column.table.getNumberOfRows();
-	// Local order buffer which represents the ordered list of row indices
-	QList<BufferRowIndex> order = QList<BufferRowIndex>();
+	const int numberOfRows = table.baseTable.getNumberOfRows();
+	
+	cachedKeys = QList<QList<SortKey>>();
+	cachedKeys.reserve(numberOfRows);
+	cachedOrder = QList<BufferRowIndex>();
+	cachedOrder.reserve(numberOfRows);
 	for (BufferRowIndex index = BufferRowIndex(0); index.isValid(numberOfRows); index++) {
-		order.append(index);
+		cachedKeys.append(computeSortKeysFor(index));
+		cachedOrder.append(index);
 	}
 	
-	for (int i = sortingPasses.size() - 1; i >= 0; i--) {
-		const BaseSortingPass sorting = sortingPasses.at(i);
+	std::sort(cachedOrder.begin(), cachedOrder.end(), [this] (BufferRowIndex index1, BufferRowIndex index2) {
+		return isSortedBefore(index1, index2);
+	});
+	cacheValid = true;
+	
+	return cachedOrder;
+}
+
+/**
+ * Extracts the sort keys for the given row from the base table, one for each sorting pass.
+ * 
+ * @param rowIndex	The buffer row index of the row in the base table.
+ * @return			The sort keys for the row, in the order of the sorting passes.
+ */
+QList<IndexCompositeColumn::SortKey> IndexCompositeColumn::computeSortKeysFor(BufferRowIndex rowIndex) const
+{
+	QList<SortKey> keys = QList<SortKey>();
+	keys.reserve(sortingPasses.size());
+	
+	for (const auto& [column, order] : sortingPasses) {
+		const QVariant value = column.getValueAt(rowIndex);
+		SortKey key = {isEmptyCell(column.type, value), 0, QString()};
+		if (key.isNull) {
+			keys.append(key);
+			continue;
+		}
 		
-		auto comparator = [&sorting](BufferRowIndex i1, BufferRowIndex i2) {
-			QVariant value1 = sorting.column.getValueAt(i1);
-			QVariant value2 = sorting.column.getValueAt(i2);
-			
-			if (sorting.order == Qt::AscendingOrder) {
-				return compareCells(sorting.column.type, value1, value2);
-			} else {
-				return compareCells(sorting.column.type, value2, value1);
-			}
-		};
+		if (column.type == String) {
+			key.string = value.toString();
+		} else {
+			key.number = getNumericSortKey(column.type, value);
+		}
+		keys.append(key);
+	}
+	
+	return keys;
+}
+
+/**
+ * Compares two rows of the base table by their cached sort keys.
+ * 
+ * Empty values are sorted first, as in compareCells(). Rows with equal keys are ordered by buffer
+ * row index.
+ * 
+ * @param rowIndex1	The buffer row index of the first row.
+ * @param rowIndex2	The buffer row index of the second row.
+ * @return			True if the first row is sorted before the second one, false otherwise.
+ */
+bool IndexCompositeColumn::isSortedBefore(BufferRowIndex rowIndex1, BufferRowIndex rowIndex2) const
+{
+	const QList<SortKey>& keys1 = cachedKeys.at(rowIndex1.get());
+	const QList<SortKey>& keys2 = cachedKeys.at(rowIndex2.get());
+	
+	for (int i = 0; i < sortingPasses.size(); i++) {
+		const SortKey& key1 = keys1.at(i);
+		const SortKey& key2 = keys2.at(i);
+		
+		int comparison = 0;
+		if (key1.isNull || key2.isNull) {
+			comparison = (int) key2.isNull - (int) key1.isNull;
+		} else if (sortingPasses.at(i).column.type == String) {
+			comparison = compareStrings(key1.string, key2.string);
+		} else {
+			comparison = (key1.number > key2.number) - (key1.number < key2.number);
+		}
+		if (comparison == 0) continue;
 		
-		std::stable_sort(order.begin(), order.end(), comparator);
+		const bool ascending = sortingPasses.at(i).order == Qt::AscendingOrder;
+		return ascending ? comparison < 0 : comparison > 0;
 	}
 	
-	return order;
+	return rowIndex1 < rowIndex2;
+}
+
+/**
+ * Finds the position of the given row in the cached order using binary search.
+ * 
+ * @pre The cached sort keys for the row are the ones used to sort it into the cached order.
+ * 
+ * @param rowIndex	The buffer row index of the row to find.
+ * @return			The position of the row in the cached order.
+ */
+int IndexCompositeColumn::findPositionOf(BufferRowIndex rowIndex) const
+{
+	const auto iter = std::lower_bound(cachedOrder.constBegin(), cachedOrder.constEnd(), rowIndex, [this] (BufferRowIndex index1, BufferRowIndex index2) {
+		return isSortedBefore(index1, index2);
+	});
+	assert(iter != cachedOrder.constEnd() && *iter == rowIndex);
+	return iter - cachedOrder.constBegin();
 }
 
 
@@ -876,7 +1274,7 @@ QVariant OrdinalCompositeColumn::computeValueAt(BufferRowIndex rowIndex) const
  */
 QList<QVariant> OrdinalCompositeColumn::computeWholeColumn() const
 {
-	QList<BufferRowIndex> order = getRowIndexOrderList();
+	const QList<BufferRowIndex> order = getRowIndexOrderList();
 	
 	QList<QVariant> ordinals = QList<QVariant>(order.size());
 	
@@ -906,6 +1304,52 @@ QList<QVariant> OrdinalCompositeColumn::computeWholeColumn() const
 
 
 
+/**
+ * Adds the new values of all cells which may have changed after rows in the given range of
+ * positions in the cached order moved.
+ * 
+ * Since rows are grouped by the separating column first, ordinals can only change within groups
+ * which overlap the range, even if a group's position did not change. These groups are numbered
+ * again from their start.
+ * 
+ * @param firstPosition	The first position in the cached order which may have changed.
+ * @param lastPosition	The last position in the cached order which may have changed.
+ * @param changedCells	The map to which the new values of all changed cells are added.
+ */
+void OrdinalCompositeColumn::collectChangedCells(int firstPosition, int lastPosition, QHash<BufferRowIndex, QVariant>& changedCells) const
+{
+	// The separating column is the first sorting pass
+	auto separatingKeyAt = [this] (int position) -> const SortKey& {
+		return cachedKeys.at(cachedOrder.at(position).get()).first();
+	};
+	auto sameGroup = [] (const SortKey& key1, const SortKey& key2) {
+		return !key1.isNull && !key2.isNull && key1.number == key2.number;
+	};
+	
+	// Go back to the start of the first affected group
+	int position = firstPosition;
+	while (position > 0 && sameGroup(separatingKeyAt(position - 1), separatingKeyAt(position))) {
+		position--;
+	}
+	
+	// Number all groups until the end of the last affected group
+	int ordinal = 0;
+	for (; position < cachedOrder.size(); position++) {
+		const SortKey& key = separatingKeyAt(position);
+		const bool startsGroup = position == 0 || !sameGroup(separatingKeyAt(position - 1), key);
+		if (position > lastPosition && startsGroup) break;
+		
+		if (Q_UNLIKELY(key.isNull)) {
+			changedCells.insert(cachedOrder.at(position), QVariant());
+			continue;
+		}
+		ordinal = startsGroup ? 1 : ordinal + 1;
+		changedCells.insert(cachedOrder.at(position), ordinal);
+	}
+}
+
+
+
 QStringList OrdinalCompositeColumn::encodeTypeSpecific() const
 {
 	// Not supported
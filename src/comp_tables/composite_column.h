@@ -83,6 +83,8 @@ public:
 	bool isFilterOnlyColumn() const;
 	
 	virtual QSet<ValidItemID> computeIDsAt(BufferRowIndex rowIndex) const;
+	virtual const NormalTable& getIDTable() const;
+	virtual BreadcrumbMapping mapRowsToIDTable(const QList<BufferRowIndex>& rowIndices) const;
 	/**
 	 * Computes the value of the cell at the given row index.
 	 *
@@ -99,15 +101,21 @@ public:
 	 * @return	Computed values for all cells in the column.
 	 */
 	virtual QList<QVariant> computeWholeColumn() const;
+	virtual bool isComputedAsWholeColumn() const;
+	virtual bool updateIncrementally(const QList<QPair<BufferRowIndex, bool>>& rowsAddedOrRemoved, const QSet<BufferRowIndex>& changedRows, QHash<BufferRowIndex, QVariant>& changedCells) const;
 	
 	QVariant getRawValueAt(BufferRowIndex rowIndex) const;
 	QVariant getFormattedValueAt(BufferRowIndex rowIndex) const;
+	bool getIntegerCells(const QList<qint32>*& values, const std::vector<bool>*& nullFlags) const;
+	bool getBitCells(const std::vector<bool>*& bits) const;
+	bool getStringCells(const QString*& arena, const QList<qint32>*& offsets, const QList<qint32>*& lengths, const std::vector<bool>*& nullFlags) const;
+	virtual bool getDualEnumCells(const QList<qint32>*& discerningValues, const std::vector<bool>*& discerningNullFlags, const QList<qint32>*& displayedValues, const std::vector<bool>*& displayedNullFlags) const;
 protected:
 	QVariant replaceEnumIfApplicable(QVariant content) const;
 public:
 	QString toFormattedTableContent(QVariant rawCellContent) const;
 	
-	bool compare(const QVariant& value1, const QVariant& value2) const;
+	QList<qint64> getSortKeys(const QList<BufferRowIndex>& rowIndices) const;
 	
 	/**
 	 * Returns a set of all columns in the base tables which are used to compute the content of
@@ -116,6 +124,8 @@ public:
 	 * @return	A set of all base table columns which are used to compute contents of this column.
 	 */
 	virtual const QSet<const Column*> getAllUnderlyingColumns() const = 0;
+	virtual const Breadcrumbs* getBreadcrumbs() const;
+	virtual const Column* getSharedBaseTableColumn() const;
 	
 protected:
 	const ProjectSettings& getProjectSettings() const;
@@ -152,6 +162,7 @@ public:
 	virtual QVariant computeValueAt(BufferRowIndex rowIndex) const override;
 	
 	virtual const QSet<const Column*> getAllUnderlyingColumns() const override;
+	virtual const Column* getSharedBaseTableColumn() const override;
 	
 protected:
 	virtual QStringList encodeTypeSpecific() const override;
@@ -175,9 +186,12 @@ public:
 	ReferenceCompositeColumn(CompositeTable& table, QString name, QString uiName, QString suffix, const Column& contentColumn);
 	
 	virtual QSet<ValidItemID> computeIDsAt(BufferRowIndex rowIndex) const override;
+	virtual const NormalTable& getIDTable() const override;
+	virtual BreadcrumbMapping mapRowsToIDTable(const QList<BufferRowIndex>& rowIndices) const override;
 	virtual QVariant computeValueAt(BufferRowIndex rowIndex) const override;
 	
 	virtual const QSet<const Column*> getAllUnderlyingColumns() const override;
+	virtual const Breadcrumbs* getBreadcrumbs() const override;
 	
 protected:
 	virtual QStringList encodeTypeSpecific() const override;
@@ -225,6 +239,8 @@ public:
 	
 	virtual QVariant computeValueAt(BufferRowIndex rowIndex) const override;
 	
+	virtual bool getDualEnumCells(const QList<qint32>*& discerningValues, const std::vector<bool>*& discerningNullFlags, const QList<qint32>*& displayedValues, const std::vector<bool>*& displayedNullFlags) const override;
+	
 	virtual const QSet<const Column*> getAllUnderlyingColumns() const override;
 	
 protected:
@@ -245,20 +261,53 @@ struct BaseSortingPass {
 
 /**
  * A composite column which indexes all rows in the table according to a given sorting.
+ * 
+ * The sort keys of all rows and the resulting order are cached, so that after small changes in
+ * the base table, the order can be updated by binary search insertion instead of sorting again.
  */
 class IndexCompositeColumn : public CompositeColumn {
+protected:
+	/**
+	 * A sort key for a single cell, extracted once from the cell value so that comparisons do not
+	 * need to go through QVariant.
+	 */
+	struct SortKey {
+		/** Whether the cell is empty. Empty cells are sorted first. */
+		bool isNull;
+		/** The numeric representation of the cell value, for all non-string types. */
+		qint64 number;
+		/** The cell value, for string types. */
+		QString string;
+	};
+	
 	/** The sorting to use for indexing, in order of last sorting round given first. */
 	const QList<BaseSortingPass> sortingPasses;
 	
+	/** The sort keys for every row in the base table, one per sorting pass, indexed by buffer row. */
+	mutable QList<QList<SortKey>> cachedKeys;
+	/** All buffer rows in the base table in sorted order. */
+	mutable QList<BufferRowIndex> cachedOrder;
+	/** Whether cachedKeys and cachedOrder have been computed and kept up to date since. */
+	mutable bool cacheValid;
+	
 public:
 	IndexCompositeColumn(CompositeTable& table, QString name, QString uiName, QString suffix, const QList<BaseSortingPass> sortingPasses, bool isOrdinal = false);
 	
 	virtual QVariant computeValueAt(BufferRowIndex rowIndex) const override;
 	QList<QVariant> computeWholeColumn() const override;
+	virtual bool updateIncrementally(const QList<QPair<BufferRowIndex, bool>>& rowsAddedOrRemoved, const QSet<BufferRowIndex>& changedRows, QHash<BufferRowIndex, QVariant>& changedCells) const override;
 	QList<BufferRowIndex> getRowIndexOrderList() const;
 	
 	virtual const QSet<const Column*> getAllUnderlyingColumns() const override;
 	
+protected:
+	virtual void collectChangedCells(int firstPosition, int lastPosition, QHash<BufferRowIndex, QVariant>& changedCells) const;
+	
+private:
+	QList<SortKey> computeSortKeysFor(BufferRowIndex rowIndex) const;
+	bool isSortedBefore(BufferRowIndex rowIndex1, BufferRowIndex rowIndex2) const;
+	int findPositionOf(BufferRowIndex rowIndex) const;
+	
 protected:
 	virtual QStringList encodeTypeSpecific() const override;
 };
@@ -278,6 +327,8 @@ public:
 	QList<QVariant> computeWholeColumn() const override;
 	
 protected:
+	virtual void collectChangedCells(int firstPosition, int lastPosition, QHash<BufferRowIndex, QVariant>& changedCells) const override;
+	
 	virtual QStringList encodeTypeSpecific() const override;
 };
 
@@ -24,8 +24,20 @@
 #include "composite_table.h"
 #include "src/db/database.h"
 #include "src/filters/filter.h"
+#include "src/settings/settings.h"
 
+#include <QDebug>
+#include <QHeaderView>
 #include <QScrollBar>
+#include <QThread>
+#include <QThreadPool>
+
+#include <atomic>
+
+
+
+const int CompositeTable::maxRowsToRepositionIndividually = 64;
+const int CompositeTable::numRowsToComputeAroundShownRow = 50;
 
 
 
@@ -46,27 +58,49 @@ CompositeTable::CompositeTable(Database& db, NormalTable& baseTable, QTableView*
 	customColumns(QList<const CompositeColumn*>()),
 	staticColumnNames(QStringList()),
 	customColumnNames(QStringList()),
+	dependentColumnsPerUnderlyingColumn(QHash<const Column*, QSet<const CompositeColumn*>>()),
+	underlyingColumnsPerColumn(QHash<const CompositeColumn*, QSet<const Column*>>()),
 	bufferInitialized(false),
 	buffer(TableBuffer()),
 	viewOrder(ViewOrderBuffer()),
 	currentSorting({nullptr, Qt::AscendingOrder}),
+	secondarySortings(QList<SortingPass>()),
 	currentFilters(QList<const Filter*>()),
 	dirtyColumns(QSet<const CompositeColumn*>()),
+	computedCellsInDirtyColumns(QHash<const CompositeColumn*, BufferRowSelection>()),
+	orderBufferDirty(false),
+	deferredSortPending(false),
+	rowsToReposition(QSet<BufferRowIndex>()),
 	hiddenColumns(QSet<const CompositeColumn*>()),
 	updateImmediately(false),
 	tableToAutoResizeAfterCompute(nullptr),
+	cellsRequestedOnDemand(QHash<const CompositeColumn*, QSet<BufferRowIndex>>()),
+	onDemandComputationTimer(),
+	backgroundColumns(QSet<const CompositeColumn*>()),
+	backgroundMutex(),
+	backgroundTaskFinished(),
+	numRunningBackgroundTasks(0),
+	finishedBackgroundResults(QList<QPair<const CompositeColumn*, QList<QVariant>>>()),
 	changeListener(TableChangeListenerCompositeTable(*this)),
 	name(baseTable.name),
 	uiName(baseTable.uiName)
 {
 	db.registerChangeListener(&changeListener);
+	
+	onDemandComputationTimer.setSingleShot(true);
+	onDemandComputationTimer.setInterval(0);
+	connect(&onDemandComputationTimer, &QTimer::timeout, this, &CompositeTable::computeCellsRequestedOnDemand);
 }
 
 /**
  * Destroys this CompositeTable.
+ * 
+ * @pre No background tasks are running anymore (see waitForBackgroundTasks()).
  */
 CompositeTable::~CompositeTable()
-{}
+{
+	assert(numRunningBackgroundTasks == 0);
+}
 
 
 
@@ -77,6 +111,8 @@ CompositeTable::~CompositeTable()
  */
 void CompositeTable::reset()
 {
+	if (bufferInitialized) waitForBackgroundUpdate();
+	
 	beginResetModel();
 	viewOrder.clear();
 	endResetModel();
@@ -85,8 +121,16 @@ void CompositeTable::reset()
 	bufferInitialized = false;
 	customColumns.clear();
 	customColumnNames.clear();
+	rebuildColumnDependencies();
+	secondarySortings.clear();
 	dirtyColumns.clear();
+	computedCellsInDirtyColumns.clear();
+	orderBufferDirty = false;
+	deferredSortPending = false;
+	rowsToReposition.clear();
 	hiddenColumns.clear();
+	cellsRequestedOnDemand.clear();
+	onDemandComputationTimer.stop();
 }
 
 
@@ -107,6 +151,7 @@ void CompositeTable::addColumn(const CompositeColumn& newColumn)
 	
 	columns.append(&newColumn);
 	staticColumnNames.append(newColumn.name);
+	rebuildColumnDependencies();
 }
 
 /**
@@ -140,15 +185,22 @@ void CompositeTable::addCustomColumn(const CompositeColumn& newColumn)
 		assert(name != newColumn.name);
 	}
 	
+	if (bufferInitialized) waitForBackgroundUpdate();
+	
 	beginInsertColumns(QModelIndex(), getNumberOfNormalColumns(), getNumberOfNormalColumns());
 	
 	customColumns.append(&newColumn);
 	customColumnNames.append(newColumn.name);
+	rebuildColumnDependencies();
 	
 	if (bufferInitialized) {
 		buffer.appendColumn();
-		dirtyColumns.insert(&newColumn);
-		updateBufferColumns({ &newColumn });
+		if (newColumn.getSharedBaseTableColumn()) {
+			shareBufferColumnWithBaseTable(newColumn);
+		} else {
+			dirtyColumns.insert(&newColumn);
+			updateBufferColumns({ &newColumn });
+		}
 	}
 	
 	endInsertColumns();
@@ -165,19 +217,59 @@ void CompositeTable::setCustomColumns(const QList<CompositeColumn*> newCustomCol
 	}
 }
 
+/**
+ * Removes the custom column at the given index and deletes it.
+ * 
+ * All references to the column are dropped before it is deleted, including pending requests for
+ * cells to compute and results of background tasks. If the table is sorted primarily by the column,
+ * the sorting is reset to the default sorting.
+ * 
+ * @param logicalIndex	The index of the custom column to remove.
+ */
 void CompositeTable::removeCustomColumnAt(int logicalIndex)
 {
 	const CompositeColumn& column = getColumnAt(logicalIndex);
 	assert(customColumns.contains(&column));
 	
+	if (bufferInitialized) waitForBackgroundUpdate();
+	
 	beginRemoveColumns(QModelIndex(), logicalIndex, logicalIndex);
 	
 	customColumns.removeAll(&column);
 	customColumnNames.removeAll(column.name);
+	rebuildColumnDependencies();
+	secondarySortings.removeIf([&column] (const SortingPass& sorting) {
+		return sorting.column == &column;
+	});
+	dirtyColumns.remove(&column);
+	backgroundColumns.remove(&column);
+	computedCellsInDirtyColumns.remove(&column);
+	cellsRequestedOnDemand.remove(&column);
+	{
+		QMutexLocker locker(&backgroundMutex);
+		finishedBackgroundResults.removeIf([&column] (const QPair<const CompositeColumn*, QList<QVariant>>& result) {
+			return result.first == &column;
+		});
+	}
 	buffer.removeColumn(logicalIndex);
 	
 	endRemoveColumns();
 	
+	if (currentSorting.column == &column) {
+		const SortingPass defaultSorting = getDefaultSorting();
+		if (bufferInitialized) {
+			// Move sort indicator without triggering a separate sort
+			QHeaderView* const header = tableView->horizontalHeader();
+			const bool oldBlockState = header->blockSignals(true);
+			header->setSortIndicator(defaultSorting.column->getIndex(), defaultSorting.order);
+			header->blockSignals(oldBlockState);
+			setSorting({ defaultSorting });
+		} else {
+			currentSorting = defaultSorting;
+			secondarySortings.clear();
+		}
+	}
+	
 	delete &column;
 }
 
@@ -367,6 +459,62 @@ QSet<QString> CompositeTable::getNormalColumnNameSet() const
 	return columnNameSet;
 }
 
+/**
+ * Rebuilds the maps between the composite columns of this table and the database columns they
+ * depend on.
+ * 
+ * To be called whenever a normal or custom column is added or removed, so that changes in the
+ * database can be routed to the affected columns without collecting their underlying columns again.
+ */
+void CompositeTable::rebuildColumnDependencies()
+{
+	dependentColumnsPerUnderlyingColumn.clear();
+	underlyingColumnsPerColumn.clear();
+	
+	const QList<const CompositeColumn*> allColumns = columns + customColumns;
+	for (const CompositeColumn* const column : allColumns) {
+		const QSet<const Column*> underlyingColumns = column->getAllUnderlyingColumns();
+		underlyingColumnsPerColumn.insert(column, underlyingColumns);
+		for (const Column* const underlyingColumn : underlyingColumns) {
+			dependentColumnsPerUnderlyingColumn[underlyingColumn].insert(column);
+		}
+	}
+}
+
+/**
+ * Returns the set of normal and custom columns whose contents depend on any of the given database
+ * columns.
+ * 
+ * @param underlyingColumns	The database columns to find dependent composite columns for.
+ * @return					The composite columns which depend on any of the given columns.
+ */
+QSet<const CompositeColumn*> CompositeTable::getColumnsDependingOn(const QSet<const Column*>& underlyingColumns) const
+{
+	QSet<const CompositeColumn*> dependentColumns = QSet<const CompositeColumn*>();
+	for (const Column* const underlyingColumn : underlyingColumns) {
+		dependentColumns.unite(dependentColumnsPerUnderlyingColumn.value(underlyingColumn));
+	}
+	return dependentColumns;
+}
+
+/**
+ * Prints the database columns each composite column of this table depends on to the debug output.
+ */
+void CompositeTable::printColumnDependencies() const
+{
+	qDebug() << "Printing column dependencies of" << name;
+	const QList<const CompositeColumn*> allColumns = columns + customColumns;
+	for (const CompositeColumn* const column : allColumns) {
+		const QSet<const Column*> underlyingColumns = underlyingColumnsPerColumn.value(column);
+		QStringList underlyingColumnNames = QStringList();
+		for (const Column* const underlyingColumn : underlyingColumns) {
+			underlyingColumnNames.append(underlyingColumn->table.name + "." + underlyingColumn->name);
+		}
+		underlyingColumnNames.sort();
+		qDebug().noquote() << column->name << "<-" << underlyingColumnNames.join(", ");
+	}
+}
+
 
 
 /**
@@ -395,48 +543,46 @@ void CompositeTable::initBuffer(QProgressDialog* progressDialog, bool deferCompu
 	assert(buffer.isEmpty() && viewOrder.isEmpty());
 	assert(dirtyColumns.isEmpty());
 	
+	// Columns shared with the base table never need to be computed
 	const QList<const CompositeColumn*> allColumns = columns + customColumns;
 	for (const CompositeColumn* column : allColumns) {
+		if (column->getSharedBaseTableColumn()) continue;
 		dirtyColumns.insert(column);
 	}
 	QSet<const CompositeColumn*> columnsToUpdate = QSet<const CompositeColumn*>();
 	if (!deferCompute) columnsToUpdate = getColumnsToUpdate();
 	
 	buffer.setInitialNumberOfColumns(allColumns.size());
+	for (const CompositeColumn* column : allColumns) {
+		if (column->getSharedBaseTableColumn()) shareBufferColumnWithBaseTable(*column);
+	}
 	
-	// Initialize cells and compute their contents for most columns
+	// Initialize all cells empty
 	const int numberOfRows = baseTable.getNumberOfRows();
+	const QList<QVariant> emptyRow = QList<QVariant>(allColumns.size(), QVariant());
 	for (BufferRowIndex bufferRowIndex = BufferRowIndex(0); bufferRowIndex.isValid(numberOfRows); bufferRowIndex++) {
-		QList<QVariant>* newRow = new QList<QVariant>();
-		for (const CompositeColumn* const column : allColumns) {
-			const bool noUpdateColumn = !columnsToUpdate.contains(column);
-			const bool computeWholeColumn = column->cellsAreInterdependent;
-			
-			QVariant newCell = QVariant();
-			if (Q_LIKELY(!noUpdateColumn && !computeWholeColumn)) {
-				newCell = computeCellContent(bufferRowIndex, column->getIndex());
-			}
-			newRow->append(newCell);
-			
-			if (Q_LIKELY(progressDialog && (!computeWholeColumn || noUpdateColumn))) {
-				progressDialog->setValue(progressDialog->value() + 1);
-			}
-		}
-		buffer.appendRow(newRow);
+		buffer.appendRow(emptyRow);
 	}
 	
-	// For columns which have to be computed as a whole, do that now
+	// Compute contents of all columns which need to be updated
+	QList<const CompositeColumn*> columnsToCompute = QList<const CompositeColumn*>();
 	for (const CompositeColumn* const column : allColumns) {
-		const bool noUpdateColumn = !columnsToUpdate.contains(column);
-		const bool computeWholeColumn = column->cellsAreInterdependent;
-		if (noUpdateColumn || !computeWholeColumn) continue;
-		
-		QList<QVariant> cells = computeWholeColumnContent(column->getIndex());
-		for (BufferRowIndex bufferRowIndex = BufferRowIndex(0); bufferRowIndex.isValid(baseTable.getNumberOfRows()); bufferRowIndex++) {
-			buffer.replaceCell(bufferRowIndex, column->getIndex(), cells.at(bufferRowIndex.get()));
-			if (Q_LIKELY(progressDialog)) {
-				progressDialog->setValue(progressDialog->value() + 1);
-			}
+		if (columnsToUpdate.contains(column)) columnsToCompute.append(column);
+	}
+	const int numSkippedCells = (allColumns.size() - columnsToCompute.size()) * numberOfRows;
+	const int progressBase = progressDialog ? progressDialog->value() + numSkippedCells : 0;
+	auto reportProgress = [progressDialog, progressBase] (int numCellsComputed) {
+		if (Q_LIKELY(progressDialog)) {
+			progressDialog->setValue(progressBase + numCellsComputed);
+		}
+	};
+	const QList<QList<QVariant>> computedColumns = computeColumnsInParallel(columnsToCompute, reportProgress);
+	
+	for (int i = 0; i < columnsToCompute.size(); i++) {
+		const int columnIndex = columnsToCompute.at(i)->getIndex();
+		const QList<QVariant>& cells = computedColumns.at(i);
+		for (BufferRowIndex bufferRowIndex = BufferRowIndex(0); bufferRowIndex.isValid(numberOfRows); bufferRowIndex++) {
+			buffer.replaceCell(bufferRowIndex, columnIndex, cells.at(bufferRowIndex.get()));
 		}
 	}
 	
@@ -452,6 +598,21 @@ void CompositeTable::initBuffer(QProgressDialog* progressDialog, bool deferCompu
 	}
 }
 
+/**
+ * Makes the buffer read the cells of the given column directly from the base table buffer instead
+ * of storing them.
+ * 
+ * @param column	The column to share with the base table. Must have a shared base table column.
+ */
+void CompositeTable::shareBufferColumnWithBaseTable(const CompositeColumn& column)
+{
+	const Column* const sharedColumn = column.getSharedBaseTableColumn();
+	assert(sharedColumn);
+	assert(&sharedColumn->table == &baseTable);
+	
+	buffer.shareColumn(column.getIndex(), baseTable.getBuffer(), sharedColumn->getIndex());
+}
+
 /**
  * Rebuilds the order buffer after changes which could affect the sorting or filtering.
  * 
@@ -463,6 +624,9 @@ void CompositeTable::initBuffer(QProgressDialog* progressDialog, bool deferCompu
  * here on are already in the order buffer, i.e., no previously applied filters have been removed
  * or relaxed in any way. In practice, this should not be done if the filters have changed at all.
  * 
+ * Filters and sorting by columns which are still being computed in the background are skipped,
+ * and the order buffer stays marked dirty so that it is rebuilt once those columns are ready.
+ * 
  * @param skipRepopulate	Whether to skip repopulating the order buffer.
  */
 void CompositeTable::rebuildOrderBuffer(bool skipRepopulate)
@@ -471,6 +635,8 @@ void CompositeTable::rebuildOrderBuffer(bool skipRepopulate)
 	
 	beginResetModel();
 	
+	rowsToReposition.clear();
+	
 	// Fill order buffer
 	if (!skipRepopulate) {
 		viewOrder.clear();
@@ -479,21 +645,47 @@ void CompositeTable::rebuildOrderBuffer(bool skipRepopulate)
 		}
 	}
 	
-	// Filter order buffer
-	for (const Filter* const filter : std::as_const(currentFilters)) {
-		filter->applyToOrderBuffer(viewOrder);
+	// Filter order buffer: combine the rows passing each filter, then remove all others at once
+	bool orderingDeferred = false;
+	if (!currentFilters.isEmpty()) {
+		BufferRowSelection passingRows = viewOrder.getSelection(buffer.numRows());
+		for (const Filter* const filter : std::as_const(currentFilters)) {
+			if (backgroundColumns.contains(&filter->columnToFilterBy)) {
+				orderingDeferred = true;
+				continue;
+			}
+			passingRows.intersect(filter->evaluateForRows(passingRows));
+		}
+		viewOrder.retainSelected(passingRows);
 	}
 	
 	// Sort order buffer
-	performSort(getCurrentSorting(), false);
+	bool sortingDeferred = false;
+	for (const SortingPass& sorting : getCurrentSortingPasses()) {
+		sortingDeferred |= backgroundColumns.contains(sorting.column);
+	}
+	if (sortingDeferred) {
+		orderingDeferred = true;
+	} else {
+		performSort(getCurrentSortingPasses(), false);
+	}
+	
+	orderBufferDirty = orderingDeferred;
 	
 	endResetModel();
+	
+	if (deferredSortPending && !sortingDeferred) {
+		deferredSortPending = false;
+		Q_EMIT wasResorted();
+	}
 }
 
 /**
  * Returns the number of cells which need to be updated.
  * 
- * This includes every column which is dirty and either not hidden or used for sorting or filtering.
+ * This includes every column which is dirty and used for sorting or filtering, or neither hidden
+ * nor computed on demand. Cells of visible columns are computed on demand when they are shown if
+ * this is enabled in the settings and possible for the column (see canBeComputedOnDemand()).
  * 
  * @return	The set of columns which need to be updated.
  */
@@ -502,8 +694,13 @@ QSet<const CompositeColumn*> CompositeTable::getColumnsToUpdate() const
 	QSet<const CompositeColumn*> columnsToUpdate = QSet<const CompositeColumn*>(dirtyColumns);
 
 	QSet<const CompositeColumn*> canStayDirty = QSet<const CompositeColumn*>(hiddenColumns);
-	if (currentSorting.column) {
-		canStayDirty.remove(currentSorting.column);
+	if (Settings::computeCellsOnDemand.get()) {
+		for (const CompositeColumn* const column : dirtyColumns) {
+			if (canBeComputedOnDemand(*column)) canStayDirty.insert(column);
+		}
+	}
+	for (const SortingPass& sorting : getCurrentSortingPasses()) {
+		canStayDirty.remove(sorting.column);
 	}
 	for (const Filter* const filter : currentFilters) {
 		canStayDirty.remove(&filter->columnToFilterBy);
@@ -531,7 +728,10 @@ int CompositeTable::getNumberOfCellsToUpdate() const
  * Updates the contents of the given columns in the buffer, if they are marked dirty.
  * 
  * After updating, the updated columns are removed from the set of dirty columns, but the order
- * buffer is not rebuilt, therefore performSort() is not called.
+ * buffer is not rebuilt, therefore performSort() is not called. Instead, rows in which cells used
+ * for sorting or filtering changed are scheduled to be repositioned.
+ * 
+ * The cell contents are computed in parallel using computeColumnsInParallel().
  * 
  * @param columnsToUpdate			The columns to potentially update.
  * @param runAfterEachCellUpdate	A lambda function to be run every time a cell value has been updated.
@@ -543,29 +743,62 @@ void CompositeTable::updateBufferColumns(QSet<const CompositeColumn*> columnsToU
 	columnsToUpdate.intersect(dirtyColumns);
 	if (columnsToUpdate.isEmpty()) return;
 	
+	if (columnsToUpdate.intersects(backgroundColumns)) {
+		// Columns must not be computed twice at the same time, so use the background results
+		waitForBackgroundUpdate();
+		columnsToUpdate.intersect(dirtyColumns);
+		if (columnsToUpdate.isEmpty()) return;
+	}
+	
 	if (!runAfterEachCellUpdate) runAfterEachCellUpdate = []() {};
 	
-	for (const CompositeColumn* column : std::as_const(columnsToUpdate)) {
-		int columnIndex = column->getIndex();
-		bool computeWholeColumn = column->cellsAreInterdependent;
-		if (!computeWholeColumn) {
-			for (BufferRowIndex bufferRowIndex = BufferRowIndex(0); bufferRowIndex.isValid(buffer.numRows()); bufferRowIndex++) {
-				QVariant newContent = computeCellContent(bufferRowIndex, columnIndex);
-				buffer.replaceCell(bufferRowIndex, columnIndex, newContent);
-				
-				runAfterEachCellUpdate();
-			}
+	// Compute all columns in parallel, running the given lambda once for every computed cell
+	const QList<const CompositeColumn*> columnsToCompute = QList<const CompositeColumn*>(columnsToUpdate.constBegin(), columnsToUpdate.constEnd());
+	int numCellsReported = 0;
+	auto reportProgress = [&numCellsReported, &runAfterEachCellUpdate] (int numCellsComputed) {
+		for (; numCellsReported < numCellsComputed; numCellsReported++) {
+			runAfterEachCellUpdate();
 		}
-		else {
-			QList<QVariant> cells = computeWholeColumnContent(columnIndex);
-			for (BufferRowIndex bufferRowIndex = BufferRowIndex(0); bufferRowIndex.isValid(baseTable.getNumberOfRows()); bufferRowIndex++) {
-				buffer.replaceCell(bufferRowIndex, columnIndex, cells.at(bufferRowIndex.get()));
-				
-				runAfterEachCellUpdate();
+	};
+	const QList<QList<QVariant>> computedColumns = computeColumnsInParallel(columnsToCompute, reportProgress);
+	
+	writeComputedColumns(columnsToCompute, computedColumns);
+	assert(!dirtyColumns.intersects(columnsToUpdate));
+}
+
+/**
+ * Writes the computed contents of the given columns to the buffer and marks them as up to date.
+ * 
+ * Columns which are no longer dirty are skipped. Rows in which cells used for sorting or filtering
+ * changed are scheduled to be repositioned, and the model is notified of the changes.
+ * 
+ * Must be called on the thread this table lives in.
+ * 
+ * @param computedColumns	The columns which were computed.
+ * @param cellsPerColumn	The computed raw values of all cells, in a list per column in the same order.
+ */
+void CompositeTable::writeComputedColumns(const QList<const CompositeColumn*>& computedColumns, const QList<QList<QVariant>>& cellsPerColumn)
+{
+	assert(QThread::currentThread() == thread());
+	assert(computedColumns.size() == cellsPerColumn.size());
+	
+	for (int i = 0; i < computedColumns.size(); i++) {
+		const CompositeColumn* const column = computedColumns.at(i);
+		if (!dirtyColumns.contains(column)) continue;
+		
+		const int columnIndex = column->getIndex();
+		const QList<QVariant>& cells = cellsPerColumn.at(i);
+		const bool collectChangedRows = isUsedForOrder(column) && !orderBufferDirty;
+		for (BufferRowIndex bufferRowIndex = BufferRowIndex(0); bufferRowIndex.isValid(buffer.numRows()); bufferRowIndex++) {
+			const QVariant& newContent = cells.at(bufferRowIndex.get());
+			if (collectChangedRows && buffer.getCell(bufferRowIndex, columnIndex) != newContent) {
+				rowsToReposition.insert(bufferRowIndex);
 			}
+			buffer.replaceCell(bufferRowIndex, columnIndex, newContent);
 		}
 		
 		dirtyColumns.remove(column);
+		computedCellsInDirtyColumns.remove(column);
 		
 		QModelIndex topLeftIndex		= index(0, columnIndex);
 		QModelIndex bottomRightIndex	= index(viewOrder.numRows(), columnIndex);
@@ -573,13 +806,13 @@ void CompositeTable::updateBufferColumns(QSet<const CompositeColumn*> columnsToU
 			Q_EMIT dataChanged(topLeftIndex, bottomRightIndex);
 		}
 	}
-	assert(!dirtyColumns.intersects(columnsToUpdate));
 }
 
 /**
  * Updates the contents of all columns which are marked dirty.
  * 
- * After updating the buffer, the order buffer is rebuilt and the model is notified of the changes.
+ * After updating the buffer, the order buffer is rebuilt or, if only some rows changed, updated
+ * row by row, and the model is notified of the changes.
  * 
  * @param runAfterEachCellUpdate	A lambda function to be run every time a cell value has been updated.
  */
@@ -588,19 +821,16 @@ void CompositeTable::updateBothBuffers(std::function<void()> runAfterEachCellUpd
 	assert(bufferInitialized);
 	
 	QSet<const CompositeColumn*> columnsToUpdate = getColumnsToUpdate();
-	if (columnsToUpdate.isEmpty()) return;
+	if (columnsToUpdate.isEmpty() && !orderBufferDirty && rowsToReposition.isEmpty()) return;
 	
 	// Update the scheduled columns
 	updateBufferColumns(columnsToUpdate, runAfterEachCellUpdate);
 	
-	// Rebuild order buffer if necessary
-	bool orderBufferDirty = columnsToUpdate.contains(currentSorting.column);
-	for (const Filter* const filter : std::as_const(currentFilters)) {
-		if (orderBufferDirty) break;
-		orderBufferDirty |= columnsToUpdate.contains(&filter->columnToFilterBy);
-	}
+	// Rebuild order buffer if necessary, otherwise only move the rows which changed
 	if (orderBufferDirty) {
 		rebuildOrderBuffer(false);
+	} else {
+		repositionRows();
 	}
 	
 	if (tableToAutoResizeAfterCompute) {
@@ -609,6 +839,162 @@ void CompositeTable::updateBothBuffers(std::function<void()> runAfterEachCellUpd
 	}
 }
 
+/**
+ * Returns the number of cells which updateAllColumnsFromWorkerThread() is going to compute.
+ * 
+ * Must be called from a worker thread. The state of the columns is read on the thread this table
+ * lives in, after all background tasks have finished.
+ * 
+ * @return	The number of cells in all dirty columns.
+ */
+int CompositeTable::getNumberOfDirtyCellsFromWorkerThread()
+{
+	assert(QThread::currentThread() != thread());
+	assert(bufferInitialized);
+	
+	int numDirtyCells = 0;
+	QMetaObject::invokeMethod(this, [this, &numDirtyCells] () {
+		waitForBackgroundUpdate();
+		numDirtyCells = dirtyColumns.size() * buffer.numRows();
+	}, Qt::BlockingQueuedConnection);
+	return numDirtyCells;
+}
+
+/**
+ * Updates the contents of all dirty columns from a worker thread, such as the export thread.
+ * 
+ * The cells are computed in parallel while the worker thread waits, as in updateBothBuffers().
+ * Reading the state of the columns, writing the results to the buffer and updating the order
+ * buffer are done on the thread this table lives in, which the worker thread blocks on meanwhile.
+ * Unlike updateBothBuffers(), this also updates columns which could be computed on demand, so that
+ * afterwards, getRawValue() only reads the buffer as long as the data is not changed.
+ * 
+ * @param runAfterEachCellUpdate	A lambda function to be run on the worker thread every time a cell value has been computed.
+ */
+void CompositeTable::updateAllColumnsFromWorkerThread(std::function<void()> runAfterEachCellUpdate)
+{
+	assert(QThread::currentThread() != thread());
+	assert(bufferInitialized);
+	
+	QList<const CompositeColumn*> columnsToCompute = QList<const CompositeColumn*>();
+	QMetaObject::invokeMethod(this, [this, &columnsToCompute] () {
+		waitForBackgroundUpdate();
+		columnsToCompute = QList<const CompositeColumn*>(dirtyColumns.constBegin(), dirtyColumns.constEnd());
+	}, Qt::BlockingQueuedConnection);
+	
+	int numCellsReported = 0;
+	auto reportProgress = [&numCellsReported, &runAfterEachCellUpdate] (int numCellsComputed) {
+		for (; numCellsReported < numCellsComputed; numCellsReported++) {
+			if (runAfterEachCellUpdate) runAfterEachCellUpdate();
+		}
+	};
+	const QList<QList<QVariant>> computedColumns = computeColumnsInParallel(columnsToCompute, reportProgress);
+	
+	QMetaObject::invokeMethod(this, [this, &columnsToCompute, &computedColumns] () {
+		writeComputedColumns(columnsToCompute, computedColumns);
+		if (orderBufferDirty) {
+			rebuildOrderBuffer(false);
+		} else {
+			repositionRows();
+		}
+	}, Qt::BlockingQueuedConnection);
+}
+
+/**
+ * Starts updating all columns which need to be updated in the background and returns immediately.
+ * 
+ * The order buffer is rebuilt right away so that all rows can be shown while the columns are being
+ * computed. Cells of columns which are not ready yet are shown empty, and sorting or filtering by
+ * them is deferred until they are. Each column is computed by a separate task on the global thread
+ * pool, starting with the cheap ones so that they appear as early as possible. Finished columns are
+ * written to the buffer one by one on the thread this table lives in.
+ * 
+ * The base tables must not be modified while background tasks are running, so before any data
+ * changes, waitForBackgroundUpdate() has to be called (see TableChangeListener).
+ */
+void CompositeTable::updateBothBuffersInBackground()
+{
+	assert(bufferInitialized);
+	
+	QSet<const CompositeColumn*> columnsToUpdate = getColumnsToUpdate();
+	columnsToUpdate.subtract(backgroundColumns);
+	if (columnsToUpdate.isEmpty() && !orderBufferDirty) {
+		repositionRows();
+		return;
+	}
+	
+	// Start with columns which are computed cell by cell and not statistical, since they are cheap
+	QList<const CompositeColumn*> columnsToCompute = QList<const CompositeColumn*>();
+	const QList<const CompositeColumn*> allColumns = columns + customColumns;
+	for (const CompositeColumn* const column : allColumns) {
+		if (columnsToUpdate.contains(column)) columnsToCompute.append(column);
+	}
+	auto isExpensive = [] (const CompositeColumn* column) {
+		return column->isComputedAsWholeColumn() || column->isStatistical;
+	};
+	std::stable_sort(columnsToCompute.begin(), columnsToCompute.end(), [&isExpensive] (const CompositeColumn* column1, const CompositeColumn* column2) {
+		return !isExpensive(column1) && isExpensive(column2);
+	});
+	
+	for (const CompositeColumn* const column : std::as_const(columnsToCompute)) {
+		backgroundColumns.insert(column);
+		{
+			QMutexLocker locker(&backgroundMutex);
+			numRunningBackgroundTasks++;
+		}
+		
+		const int columnIndex = column->getIndex();
+		QThreadPool::globalInstance()->start([this, column, columnIndex] () {
+			QList<QVariant> cells = QList<QVariant>();
+			if (column->isComputedAsWholeColumn()) {
+				cells = computeWholeColumnContent(columnIndex);
+			} else {
+				const int numberOfRows = baseTable.getNumberOfRows();
+				cells.reserve(numberOfRows);
+				for (BufferRowIndex bufferRowIndex = BufferRowIndex(0); bufferRowIndex.isValid(numberOfRows); bufferRowIndex++) {
+					cells.append(computeCellContent(bufferRowIndex, columnIndex));
+				}
+			}
+			
+			QMutexLocker locker(&backgroundMutex);
+			finishedBackgroundResults.append({column, cells});
+			QMetaObject::invokeMethod(this, [this] () { applyFinishedBackgroundResults(); }, Qt::QueuedConnection);
+			numRunningBackgroundTasks--;
+			backgroundTaskFinished.wakeAll();
+		});
+	}
+	
+	// Show all rows right away
+	rebuildOrderBuffer(false);
+}
+
+/**
+ * Blocks until all background tasks started by updateBothBuffersInBackground() have finished, then
+ * writes their results to the buffer.
+ * 
+ * Must be called on the thread this table lives in.
+ */
+void CompositeTable::waitForBackgroundUpdate()
+{
+	waitForBackgroundTasks();
+	applyFinishedBackgroundResults();
+}
+
+/**
+ * Blocks until all background tasks started by updateBothBuffersInBackground() have finished,
+ * without writing their results to the buffer.
+ * 
+ * Has to be called before the table is destroyed, while the columns of subclasses, which the tasks
+ * read from, still exist.
+ */
+void CompositeTable::waitForBackgroundTasks()
+{
+	QMutexLocker locker(&backgroundMutex);
+	while (numRunningBackgroundTasks > 0) {
+		backgroundTaskFinished.wait(&backgroundMutex);
+	}
+}
+
 /**
  * Returns the index at which the item shown at the given view row is stored in the buffer.
  * 
@@ -642,6 +1028,13 @@ ViewRowIndex CompositeTable::findViewRowIndexForBufferRow(BufferRowIndex bufferR
  * Returns the raw (unformatted, not for UI display) value of the cell at the given buffer row and
  * column indices.
  * 
+ * If the column is currently being computed in the background, this waits for the result instead
+ * of computing the column a second time concurrently.
+ * 
+ * On other threads, the buffer and the state of the columns are only read, never written, and
+ * the table must not be modified concurrently. Dirty cells are then computed without storing
+ * them. To avoid this, bring all columns up to date first (see updateAllColumnsFromWorkerThread()).
+ * 
  * @param bufferRowIndex	The index of the buffer row to return the value for.
  * @param column			The column to return the value for.
  * @return					The raw value of the cell at the given buffer row and column index.
@@ -652,15 +1045,31 @@ QVariant CompositeTable::getRawValue(BufferRowIndex bufferRowIndex, const Compos
 	assert(columns.contains(&column) || customColumns.contains(&column));
 	assert(bufferRowIndex.isValid(buffer.numRows()));
 	
+	const bool onOwnerThread = QThread::currentThread() == thread();
+	if (!onOwnerThread) {
+		// Buffer and column state must not be written from other threads
+		assert(!backgroundColumns.contains(&column));
+	} else if (backgroundColumns.contains(&column)) {
+		// The column must not be computed here at the same time, so use the background result
+		waitForBackgroundUpdate();
+	}
+	
 	QVariant result;
 	if (dirtyColumns.contains(&column)) {
-		if (column.cellsAreInterdependent) {
+		if (!onOwnerThread) {
+			// Compute without touching the buffer
+			if (column.cellsAreInterdependent) {
+				result = computeWholeColumnContent(column.getIndex()).at(bufferRowIndex.get());
+			} else {
+				result = column.computeValueAt(bufferRowIndex);
+			}
+		} else if (column.cellsAreInterdependent) {
 			// Have to compute whole column anyway, might as well update the buffer
 			updateBufferColumns({ &column });
 			result = buffer.getCell(bufferRowIndex, column.getIndex());
 		} else {
 			// Compute single cell instead of updating buffer for entire column to save time
-			result = column.computeValueAt(bufferRowIndex);
+			result = computeCellOnDemand(bufferRowIndex, column);
 		}
 	} else {
 		// Buffer is up to date
@@ -686,98 +1095,414 @@ QVariant CompositeTable::getFormattedValue(BufferRowIndex bufferRowIndex, const
 
 
 /**
- * Returns the current sorting.
+ * Provides direct read access to the cells of the given column in the buffer, if they are up to
+ * date and stored as integers (see TableBuffer::getIntegerColumn()).
  * 
- * @return	The current sorting as a pair of the column to sort by and the sort order.
+ * @param column	The column to access.
+ * @param values	Set to the integer values of all cells in the column, if applicable.
+ * @param nullFlags	Set to the flags marking empty cells in the column, if applicable.
+ * @return			True if the column's cells can be read directly as integers, false otherwise.
  */
-SortingPass CompositeTable::getCurrentSorting() const
+bool CompositeTable::getIntegerBufferColumn(const CompositeColumn& column, const QList<qint32>*& values, const std::vector<bool>*& nullFlags) const
 {
-	return currentSorting;
+	assert(bufferInitialized);
+	assert(columns.contains(&column) || customColumns.contains(&column));
+	
+	if (dirtyColumns.contains(&column) || backgroundColumns.contains(&column)) return false;
+	return buffer.getIntegerColumn(column.getIndex(), column.contentType, values, nullFlags);
 }
 
-
-
 /**
- * Sets filters without applying them, only to be used during initialization.
+ * Provides direct read access to the cells of the given column in the buffer, if they are up to
+ * date and stored as bits (see TableBuffer::getBitColumn()).
  * 
- * @param filters	The filters to apply once the table is populated.
+ * @param column	The column to access.
+ * @param bits		Set to the values of all cells in the column, if applicable.
+ * @return			True if the column's cells can be read directly as bits, false otherwise.
  */
-void CompositeTable::setInitialFilters(const QList<const Filter*>& filters)
+bool CompositeTable::getBitBufferColumn(const CompositeColumn& column, const std::vector<bool>*& bits) const
 {
-	assert(!bufferInitialized && viewOrder.isEmpty());
-	currentFilters = filters;
+	assert(bufferInitialized);
+	assert(columns.contains(&column) || customColumns.contains(&column));
+	
+	if (dirtyColumns.contains(&column) || backgroundColumns.contains(&column)) return false;
+	return buffer.getBitColumn(column.getIndex(), bits);
 }
 
 /**
- * Applies the given filters to the table, updating the order buffer and attempting to restore the
- * selection in the view.
- * 
- * @param filters	The filters to apply.
+ * Provides direct read access to the cells of the given column in the buffer, if they are up to
+ * date and stored in a string arena (see TableBuffer::getStringColumn()).
+ * 
+ * @param column	The column to access.
+ * @param arena		Set to the string arena containing the cells of the column, if applicable.
+ * @param offsets	Set to the offsets of all cells in the string arena, if applicable.
+ * @param lengths	Set to the lengths of all cells in the string arena, if applicable.
+ * @param nullFlags	Set to the flags marking empty cells in the column, if applicable.
+ * @return			True if the column's cells can be read directly as strings, false otherwise.
  */
-void CompositeTable::applyFilters(const QList<const Filter*>& filters)
+bool CompositeTable::getStringBufferColumn(const CompositeColumn& column, const QString*& arena, const QList<qint32>*& offsets, const QList<qint32>*& lengths, const std::vector<bool>*& nullFlags) const
 {
-	ViewRowIndex previouslySelectedViewRowIndex = ViewRowIndex(tableView->currentIndex().row());
-	BufferRowIndex previouslySelectedBufferRowIndex = getBufferRowIndexForViewRow(previouslySelectedViewRowIndex);
-	
-	const bool skipRepopulate = currentFilters.isEmpty();
-	currentFilters = filters;
-	rebuildOrderBuffer(skipRepopulate);
+	assert(bufferInitialized);
+	assert(columns.contains(&column) || customColumns.contains(&column));
 	
-	// Restore selection
-	if (previouslySelectedBufferRowIndex.isValid()) {
-		ViewRowIndex newViewRowIndex = findViewRowIndexForBufferRow(previouslySelectedBufferRowIndex);
-		QModelIndex modelIndex = index(newViewRowIndex.get(), 0);
-		tableView->setCurrentIndex(modelIndex);
-		tableView->scrollTo(modelIndex);
-	}
+	if (dirtyColumns.contains(&column) || backgroundColumns.contains(&column)) return false;
+	return buffer.getStringColumn(column.getIndex(), arena, offsets, lengths, nullFlags);
 }
 
-/**
- * Removes all applied filters from the table and performs the necessary updates.
- */
-void CompositeTable::clearFilters()
-{
-	applyFilters({});
-}
+
 
 /**
- * Returns the currently applied filters.
+ * Returns the current sorting.
  * 
- * @return	The set of currently applied filters.
+ * @return	The current sorting as a pair of the column to sort by and the sort order.
  */
-QList<const Filter*> CompositeTable::getCurrentFilters() const
+SortingPass CompositeTable::getCurrentSorting() const
 {
-	return currentFilters;
+	return currentSorting;
 }
 
 /**
- * Indicates whether any filters are currently applied to the table.
+ * Returns all passes of the current sorting, starting with the primary one.
  * 
- * @return	True if any filters are currently applied, false otherwise.
+ * @return	The current sorting followed by all secondary sortings, or an empty list if not sorted.
  */
-bool CompositeTable::filterIsActive() const
+QList<SortingPass> CompositeTable::getCurrentSortingPasses() const
 {
-	return !currentFilters.isEmpty();
+	if (!currentSorting.column) return {};
+	return QList<SortingPass>({ currentSorting }) + secondarySortings;
 }
 
-
-
 /**
- * Marks the given column as hidden.
+ * Sorts the table by the given sorting passes at once.
  * 
- * A hidden column is not updated unless it is used for sorting and/or filtering.
+ * The first pass becomes the current sorting, all further passes are used to break ties in order.
+ * If any of the columns is still being computed in the background, sorting is deferred until all
+ * of them are ready.
  * 
- * @param columnIndex	The index of the column to mark as hidden.
+ * @param sortingPasses	The sorting passes to apply, in order of decreasing priority.
  */
-void CompositeTable::markColumnHidden(int columnIndex)
+void CompositeTable::setSorting(const QList<SortingPass>& sortingPasses)
 {
-	hiddenColumns.insert(&getColumnAt(columnIndex));
+	assert(!sortingPasses.isEmpty());
+	
+	const QList<SortingPass> previousSorting = getCurrentSortingPasses();
+	currentSorting = sortingPasses.first();
+	secondarySortings = sortingPasses.mid(1);
+	
+	// Update markers for secondary sortings
+	if (getNumberOfNormalColumns() > 0) {
+		Q_EMIT headerDataChanged(Qt::Horizontal, 0, getNumberOfNormalColumns() - 1);
+	}
+	
+	QSet<const CompositeColumn*> sortColumns = QSet<const CompositeColumn*>();
+	for (const SortingPass& sorting : sortingPasses) {
+		assert(sorting.column);
+		sortColumns.insert(sorting.column);
+	}
+	
+	if (sortColumns.intersects(backgroundColumns)) {
+		// Sort once the columns are ready
+		orderBufferDirty = true;
+		deferredSortPending = true;
+		return;
+	}
+	
+	if (bufferInitialized) updateBufferColumns(sortColumns);	// Sort columns might need to be updated if hidden
+	
+	// Remember horizontal scroll
+	const int horizontalScroll = tableView->horizontalScrollBar()->value();
+	
+	performSort(previousSorting, true);
+	
+	// Restore horizontal scroll and emit signal
+	tableView->horizontalScrollBar()->setValue(horizontalScroll);
+	Q_EMIT wasResorted();
 }
 
 /**
- * Marks the given column as not hidden, but does not perform an automatic buffer update.
+ * Adds the given column as the last secondary sorting, or reverses its sort order if it already is
+ * a secondary sorting, and resorts the table.
  * 
- * @param columnIndex	The index of the column to mark as not hidden.
+ * Does nothing if the table is not sorted yet or if the column is the primary sorting column. The
+ * primary sorting is reversed through the view's sort indicator instead (see sort()).
+ * 
+ * @param columnIndex	The index of the column to additionally sort by.
+ * @param defaultOrder	The sort order to use if the column is not yet used for sorting.
+ */
+void CompositeTable::addSecondarySorting(int columnIndex, Qt::SortOrder defaultOrder)
+{
+	assert(columnIndex >= 0 && columnIndex < getNumberOfNormalColumns());
+	const CompositeColumn& column = getColumnAt(columnIndex);
+	if (!currentSorting.column || &column == currentSorting.column) return;
+	
+	QList<SortingPass> sortingPasses = getCurrentSortingPasses();
+	bool found = false;
+	for (SortingPass& sorting : sortingPasses) {
+		if (sorting.column != &column) continue;
+		sorting.order = sorting.order == Qt::AscendingOrder ? Qt::DescendingOrder : Qt::AscendingOrder;
+		found = true;
+	}
+	if (!found) {
+		sortingPasses.append({&column, defaultOrder});
+	}
+	
+	setSorting(sortingPasses);
+}
+
+/**
+ * Determines whether the given column is used in any pass of the current sorting.
+ * 
+ * @param column	The column to check.
+ * @return			True if the table is currently sorted by the given column, false otherwise.
+ */
+bool CompositeTable::isUsedForSorting(const CompositeColumn* column) const
+{
+	if (column == currentSorting.column) return true;
+	for (const SortingPass& sorting : secondarySortings) {
+		if (sorting.column == column) return true;
+	}
+	return false;
+}
+
+/**
+ * Determines whether the given column is used for sorting or filtering.
+ * 
+ * @param column	The column to check.
+ * @return			True if the order buffer depends on the values in the given column, false otherwise.
+ */
+bool CompositeTable::isUsedForOrder(const CompositeColumn* column) const
+{
+	if (isUsedForSorting(column)) return true;
+	for (const Filter* const filter : currentFilters) {
+		if (&filter->columnToFilterBy == column) return true;
+	}
+	return false;
+}
+
+
+
+/**
+ * Brings all rows scheduled for repositioning to their correct place in the order buffer and
+ * notifies the model of each removed and inserted row.
+ * 
+ * First, all scheduled rows are taken out of the order buffer, so that the remaining rows are in
+ * order. Then, for each scheduled row, the filters are evaluated for just that row. If it passes,
+ * its new position is found by binary search among the rows already in the order buffer, using
+ * sort keys which are extracted once for all rows involved, like in performSort(). This way,
+ * the model does not have to be reset after small changes, so that the scroll position in the view
+ * is preserved. The current row in the view is restored afterwards.
+ * 
+ * If the order buffer is dirty, nothing is done since it will be rebuilt anyway. If any column used
+ * for sorting or filtering is not up to date yet, the rows are kept scheduled until it is. If more
+ * than maxRowsToRepositionIndividually rows are scheduled, the order buffer is rebuilt instead.
+ */
+void CompositeTable::repositionRows()
+{
+	if (rowsToReposition.isEmpty() || orderBufferDirty) return;
+	
+	for (const CompositeColumn* const column : std::as_const(dirtyColumns)) {
+		if (isUsedForOrder(column)) return;
+	}
+	for (const CompositeColumn* const column : std::as_const(backgroundColumns)) {
+		if (isUsedForOrder(column)) return;
+	}
+	
+	// Repositioning takes linear time per row, so rebuild the order buffer after larger changes
+	if (rowsToReposition.size() > maxRowsToRepositionIndividually) {
+		rebuildOrderBuffer(false);
+		return;
+	}
+	
+	QList<BufferRowIndex> rowsInOrder = QList<BufferRowIndex>(rowsToReposition.constBegin(), rowsToReposition.constEnd());
+	std::sort(rowsInOrder.begin(), rowsInOrder.end());
+	rowsToReposition.clear();
+	
+	const ViewRowIndex previouslySelectedViewRowIndex = ViewRowIndex(tableView->currentIndex().row());
+	const BufferRowIndex previouslySelectedBufferRowIndex = getBufferRowIndexForViewRow(previouslySelectedViewRowIndex);
+	
+	// Take all scheduled rows out, leaving only rows which are in order
+	for (const BufferRowIndex& bufferRowIndex : std::as_const(rowsInOrder)) {
+		assert(bufferRowIndex.isValid(buffer.numRows()));
+		const ViewRowIndex oldViewRowIndex = viewOrder.findViewRowIndexForBufferRow(bufferRowIndex);
+		if (oldViewRowIndex.isInvalid()) continue;
+		
+		beginRemoveRows(QModelIndex(), oldViewRowIndex.get(), oldViewRowIndex.get());
+		viewOrder.removeViewRow(oldViewRowIndex);
+		endRemoveRows();
+	}
+	
+	QList<BufferRowIndex> rowsToInsert = QList<BufferRowIndex>();
+	for (const BufferRowIndex& bufferRowIndex : std::as_const(rowsInOrder)) {
+		if (passesFilters(bufferRowIndex)) rowsToInsert.append(bufferRowIndex);
+	}
+	
+	// Extract sort keys once for all involved rows, as in performSort(), indexed by buffer row
+	const QList<BufferRowIndex> keyedRows = viewOrder.getBufferRowIndices() + rowsToInsert;
+	QList<QList<qint64>> sortKeysByBufferRow = QList<QList<qint64>>();
+	QList<Qt::SortOrder> sortOrders = QList<Qt::SortOrder>();
+	if (!rowsToInsert.isEmpty()) {
+		for (const auto& [column, order] : getCurrentSortingPasses()) {
+			const QList<qint64> keys = column->getSortKeys(keyedRows);
+			QList<qint64> keysByBufferRow = QList<qint64>(buffer.numRows(), 0);
+			for (int i = 0; i < keyedRows.size(); i++) {
+				keysByBufferRow[keyedRows.at(i).get()] = keys.at(i);
+			}
+			sortKeysByBufferRow.append(keysByBufferRow);
+			sortOrders.append(order);
+		}
+	}
+	
+	// Insert the rows which pass the filters again, each after all rows not sorted after it
+	for (const BufferRowIndex& bufferRowIndex : std::as_const(rowsToInsert)) {
+		int low = 0;
+		int high = viewOrder.numRows();
+		while (low < high) {
+			const int middle = low + (high - low) / 2;
+			const BufferRowIndex middleBufferRowIndex = viewOrder.getBufferRowIndexForViewRow(ViewRowIndex(middle));
+			if (isSortedBefore(bufferRowIndex, middleBufferRowIndex, sortKeysByBufferRow, sortOrders)) {
+				high = middle;
+			} else {
+				low = middle + 1;
+			}
+		}
+		const ViewRowIndex newViewRowIndex = ViewRowIndex(low);
+		
+		beginInsertRows(QModelIndex(), newViewRowIndex.get(), newViewRowIndex.get());
+		viewOrder.insert(newViewRowIndex, bufferRowIndex);
+		endInsertRows();
+	}
+	
+	// Restore selection
+	if (previouslySelectedBufferRowIndex.isValid()) {
+		const ViewRowIndex newViewRowIndex = findViewRowIndexForBufferRow(previouslySelectedBufferRowIndex);
+		if (newViewRowIndex.isValid()) {
+			tableView->setCurrentIndex(index(newViewRowIndex.get(), tableView->currentIndex().column()));
+		}
+	}
+}
+
+/**
+ * Determines whether the given buffer row passes all current filters.
+ * 
+ * @param bufferRowIndex	The buffer row index of the row to check.
+ * @return					True if the row passes all filters, false otherwise.
+ */
+bool CompositeTable::passesFilters(BufferRowIndex bufferRowIndex) const
+{
+	BufferRowSelection row = BufferRowSelection(buffer.numRows(), false);
+	row.select(bufferRowIndex);
+	
+	for (const Filter* const filter : currentFilters) {
+		if (!filter->evaluateForRows(row).contains(bufferRowIndex)) return false;
+	}
+	return true;
+}
+
+/**
+ * Compares two buffer rows by the given precomputed sort keys of all sorting passes.
+ * 
+ * @param bufferRowIndex1		The buffer row index of the first row.
+ * @param bufferRowIndex2		The buffer row index of the second row.
+ * @param sortKeysByBufferRow	The sort keys for each sorting pass, indexed by buffer row. Must be computed together for both rows.
+ * @param sortOrders			The sort order for each sorting pass.
+ * @return						True if the first row is sorted strictly before the second one, false otherwise.
+ */
+bool CompositeTable::isSortedBefore(BufferRowIndex bufferRowIndex1, BufferRowIndex bufferRowIndex2, const QList<QList<qint64>>& sortKeysByBufferRow, const QList<Qt::SortOrder>& sortOrders)
+{
+	assert(sortKeysByBufferRow.size() == sortOrders.size());
+	
+	for (int pass = 0; pass < sortKeysByBufferRow.size(); pass++) {
+		const qint64 key1 = sortKeysByBufferRow.at(pass).at(bufferRowIndex1.get());
+		const qint64 key2 = sortKeysByBufferRow.at(pass).at(bufferRowIndex2.get());
+		if (key1 == key2) continue;
+		return (key1 < key2) == (sortOrders.at(pass) == Qt::AscendingOrder);
+	}
+	return false;
+}
+
+
+
+/**
+ * Sets filters without applying them, only to be used during initialization.
+ * 
+ * @param filters	The filters to apply once the table is populated.
+ */
+void CompositeTable::setInitialFilters(const QList<const Filter*>& filters)
+{
+	assert(!bufferInitialized && viewOrder.isEmpty());
+	currentFilters = filters;
+}
+
+/**
+ * Applies the given filters to the table, updating the order buffer and attempting to restore the
+ * selection in the view.
+ * 
+ * @param filters	The filters to apply.
+ */
+void CompositeTable::applyFilters(const QList<const Filter*>& filters)
+{
+	ViewRowIndex previouslySelectedViewRowIndex = ViewRowIndex(tableView->currentIndex().row());
+	BufferRowIndex previouslySelectedBufferRowIndex = getBufferRowIndexForViewRow(previouslySelectedViewRowIndex);
+	
+	const bool skipRepopulate = currentFilters.isEmpty();
+	currentFilters = filters;
+	rebuildOrderBuffer(skipRepopulate);
+	
+	// Restore selection
+	if (previouslySelectedBufferRowIndex.isValid()) {
+		ViewRowIndex newViewRowIndex = findViewRowIndexForBufferRow(previouslySelectedBufferRowIndex);
+		QModelIndex modelIndex = index(newViewRowIndex.get(), 0);
+		tableView->setCurrentIndex(modelIndex);
+		tableView->scrollTo(modelIndex);
+	}
+}
+
+/**
+ * Removes all applied filters from the table and performs the necessary updates.
+ */
+void CompositeTable::clearFilters()
+{
+	applyFilters({});
+}
+
+/**
+ * Returns the currently applied filters.
+ * 
+ * @return	The set of currently applied filters.
+ */
+QList<const Filter*> CompositeTable::getCurrentFilters() const
+{
+	return currentFilters;
+}
+
+/**
+ * Indicates whether any filters are currently applied to the table.
+ * 
+ * @return	True if any filters are currently applied, false otherwise.
+ */
+bool CompositeTable::filterIsActive() const
+{
+	return !currentFilters.isEmpty();
+}
+
+
+
+/**
+ * Marks the given column as hidden.
+ * 
+ * A hidden column is not updated unless it is used for sorting and/or filtering.
+ * 
+ * @param columnIndex	The index of the column to mark as hidden.
+ */
+void CompositeTable::markColumnHidden(int columnIndex)
+{
+	hiddenColumns.insert(&getColumnAt(columnIndex));
+}
+
+/**
+ * Marks the given column as not hidden, but does not perform an automatic buffer update.
+ * 
+ * @param columnIndex	The index of the column to mark as not hidden.
  */
 void CompositeTable::markColumnUnhidden(int columnIndex)
 {
@@ -813,65 +1538,480 @@ bool CompositeTable::isColumnHidden(const CompositeColumn& column) const
  * Sets whether the table should update its columns immediately when notified of changes in the
  * database, or defer the updates.
  * 
- * If the new setting is to update immediately, the buffer is then updated where necessary. A
- * progress dialog can be passed to track progress during the update process.
+ * If the new setting is to update immediately, the buffer is then updated in the background where
+ * necessary. Since this does not block, there is no progress to report, so unlike the synchronous
+ * updateBothBuffers(), this function takes no progress dialog.
  * 
  * @param updateImmediately	Whether to update columns immediately after changes.
- * @param progress			A progress dialog to update while updating the buffer.
  */
-void CompositeTable::setUpdateImmediately(bool updateImmediately, QProgressDialog* progress)
+void CompositeTable::setUpdateImmediately(bool updateImmediately)
 {
 	this->updateImmediately = updateImmediately;
 	
-	auto progressUpdateLambda = [progress] () {
-		progress->setValue(progress->value() + 1);
-	};
 	if (updateImmediately && bufferInitialized) {
-		updateBothBuffers(progressUpdateLambda);
+		updateBothBuffersInBackground();
 	}
 }
 
 
 /**
- * Receives a notification of changes in the database, changes buffer sizes, marks affected columns
- * as dirty, and updates the buffer if the table is set to update immediately.
+ * Receives a notification of changes in the database, changes buffer sizes, updates or marks
+ * affected columns as dirty, and updates the buffer if the table is set to update immediately.
+ * 
+ * Where possible, changes are propagated at row level: For each affected column, the changed rows
+ * in the base tables are mapped back to the rows of this table whose cells depend on them, and only
+ * those cells are recomputed right away. Columns where this is not possible are marked dirty and
+ * recomputed as a whole.
  * 
- * @param affectedColumns		The database columns in which changes occurred.
- * @param rowsAddedOrRemoved	The rows which were added or removed, and whether they were added (true) or removed (false).
+ * @param affectedColumns				The database columns in which changes occurred.
+ * @param rowsAddedOrRemovedPerTable	The rows which were added or removed in each table, and whether they were added (true) or removed (false).
+ * @param changedRowsPerColumn			The rows in which existing cells were changed, for each affected database column.
  */
-void CompositeTable::announceChanges(const QSet<const Column*>& affectedColumns, const QList<QPair<BufferRowIndex, bool>>& rowsAddedOrRemoved)
+void CompositeTable::announceChanges(const QSet<const Column*>& affectedColumns, const QHash<const Table*, QList<QPair<BufferRowIndex, bool>>>& rowsAddedOrRemovedPerTable, const QHash<const Column*, QSet<BufferRowIndex>>& changedRowsPerColumn)
 {
 	if (!bufferInitialized) return;
 	
+	const QList<QPair<BufferRowIndex, bool>> rowsAddedOrRemoved = rowsAddedOrRemovedPerTable.value(&baseTable);
 	const bool rowChanges = !rowsAddedOrRemoved.isEmpty();
 	assert(!rowChanges || !affectedColumns.isEmpty());
 	
 	/* Update number of rows in buffer. Contents will be updated later.
 	 * CAUTION: This method cannot be used to accurately insert and remove the correct rows if rows
 	 * were both added and removed in the same call. All columns need to be marked dirty and updated
-	 * before reading the buffer again.
+	 * before reading the buffer again, and the order buffer has to be rebuilt.
+	 * Otherwise, the order buffer is kept in sync with the buffer, and added rows are sorted into it
+	 * once their contents are known.
 	 */
+	bool anyRowsAdded = false;
+	bool anyRowsRemoved = false;
+	for (const auto& [_, addedNotRemoved] : rowsAddedOrRemoved) {
+		anyRowsAdded	|= addedNotRemoved;
+		anyRowsRemoved	|= !addedNotRemoved;
+	}
+	const bool adjustOrder = !orderBufferDirty && !(anyRowsAdded && anyRowsRemoved);
 	for (const auto& [bufferRowIndex, addedNotRemoved] : rowsAddedOrRemoved) {
 		if (addedNotRemoved) {
-			buffer.insertRow(bufferRowIndex, new QList<QVariant>(columns.size(), QVariant()));
+			insertBufferRow(bufferRowIndex, adjustOrder);
 		} else {
-			buffer.removeRow(bufferRowIndex);
+			removeBufferRow(bufferRowIndex, adjustOrder);
 		}
 	}
+	if (rowChanges && !adjustOrder) orderBufferDirty = true;
 	
 	bool anyDataChanged = rowChanges;
+	const QSet<const CompositeColumn*> affectedCompositeColumns = getColumnsDependingOn(affectedColumns);
 	const QList<const CompositeColumn*> allColumns = columns + customColumns;
 	for (const CompositeColumn* const column : allColumns) {
-		const bool affected = rowChanges || column->getAllUnderlyingColumns().intersects(affectedColumns);
+		const bool affected = rowChanges || affectedCompositeColumns.contains(column);
 		if (!affected) continue;
+		anyDataChanged = true;
+		
+		// Columns shared with the base table are already up to date
+		const Column* const sharedColumn = column->getSharedBaseTableColumn();
+		if (sharedColumn) {
+			announceChangesInSharedColumn(*column, changedRowsPerColumn.value(sharedColumn), anyRowsRemoved);
+			continue;
+		}
+		
+		if (dirtyColumns.contains(column)) {
+			resetCellsComputedOnDemand(*column);
+			continue;
+		}
+		
+		// Try to find the rows which need to be recomputed, otherwise fall back to whole column
+		QSet<BufferRowIndex> affectedBufferRows = QSet<BufferRowIndex>();
+		const bool rowLevelPossible = !(anyRowsAdded && anyRowsRemoved) && findAffectedBufferRows(*column, affectedColumns, rowsAddedOrRemovedPerTable, changedRowsPerColumn, affectedBufferRows);
+		if (rowLevelPossible) {
+			updateBufferCells(*column, affectedBufferRows);
+			continue;
+		}
+		
+		// Columns with interdependent cells may be able to find their changed cells themselves
+		if (column->cellsAreInterdependent && !(anyRowsAdded && anyRowsRemoved)) {
+			QSet<BufferRowIndex> changedBaseTableRows = QSet<BufferRowIndex>();
+			const QSet<const Column*> underlyingColumns = underlyingColumnsPerColumn.value(column);
+			for (const Column* const underlyingColumn : underlyingColumns) {
+				if (&underlyingColumn->table != &baseTable) continue;
+				changedBaseTableRows.unite(changedRowsPerColumn.value(underlyingColumn));
+			}
+			QHash<BufferRowIndex, QVariant> changedCells = QHash<BufferRowIndex, QVariant>();
+			if (column->updateIncrementally(rowsAddedOrRemoved, changedBaseTableRows, changedCells)) {
+				writeBufferCells(*column, changedCells);
+				continue;
+			}
+		}
 		
 		dirtyColumns.insert(column);
-		anyDataChanged = true;
+		resetCellsComputedOnDemand(*column);
 	}
 	
 	if (anyDataChanged && updateImmediately) updateBothBuffers();
 }
 
+/**
+ * Handles changes in the base table column underlying a column which is shared with the base
+ * table.
+ * 
+ * Since the cells of such a column are read from the base table buffer, they do not need to be
+ * updated. Only their cached formatted values are discarded, rows whose position in the order
+ * buffer might have changed are scheduled to be repositioned, and the view is notified of the
+ * changed cells.
+ * 
+ * @param column			The shared column.
+ * @param changedBufferRows	The buffer rows in which cells of the underlying base table column were changed.
+ * @param anyRowsRemoved	Whether rows were removed from the base table in the same change, making the changed row indices unreliable.
+ */
+void CompositeTable::announceChangesInSharedColumn(const CompositeColumn& column, const QSet<BufferRowIndex>& changedBufferRows, bool anyRowsRemoved)
+{
+	if (changedBufferRows.isEmpty()) return;
+	
+	const int columnIndex = column.getIndex();
+	if (anyRowsRemoved) {
+		buffer.discardFormattedColumn(columnIndex);
+	} else {
+		for (const BufferRowIndex& bufferRowIndex : changedBufferRows) {
+			buffer.discardFormattedCell(bufferRowIndex, columnIndex);
+		}
+	}
+	
+	if (isUsedForOrder(&column)) {
+		if (anyRowsRemoved) {
+			orderBufferDirty = true;
+		} else if (!orderBufferDirty) {
+			rowsToReposition.unite(changedBufferRows);
+		}
+	}
+	if (orderBufferDirty) return;
+	
+	if (anyRowsRemoved) {
+		const QModelIndex topIndex = index(0, columnIndex);
+		const QModelIndex bottomIndex = index(rowCount() - 1, columnIndex);
+		if (topIndex.isValid() && bottomIndex.isValid()) {
+			Q_EMIT dataChanged(topIndex, bottomIndex);
+		}
+		return;
+	}
+	for (const BufferRowIndex& bufferRowIndex : changedBufferRows) {
+		const ViewRowIndex viewRowIndex = viewOrder.findViewRowIndexForBufferRow(bufferRowIndex);
+		if (viewRowIndex.isInvalid()) continue;
+		const QModelIndex modelIndex = index(viewRowIndex.get(), columnIndex);
+		if (modelIndex.isValid()) {
+			Q_EMIT dataChanged(modelIndex, modelIndex);
+		}
+	}
+}
+
+/**
+ * Inserts an empty row into the buffer.
+ * 
+ * If the order buffer is to be adjusted, the buffer row indices stored in it are shifted
+ * accordingly and the new row is scheduled to be sorted into it (see repositionRows()).
+ * 
+ * @param bufferRowIndex	The buffer row index at which to insert the row.
+ * @param adjustOrder		Whether to keep the order buffer in sync instead of rebuilding it later.
+ */
+void CompositeTable::insertBufferRow(BufferRowIndex bufferRowIndex, bool adjustOrder)
+{
+	buffer.insertRow(bufferRowIndex, QList<QVariant>(columns.size() + customColumns.size(), QVariant()));
+	if (!adjustOrder) return;
+	
+	viewOrder.adjustForInsertedBufferRow(bufferRowIndex);
+	QSet<BufferRowIndex> shiftedRowsToReposition = QSet<BufferRowIndex>();
+	for (const BufferRowIndex& rowIndex : std::as_const(rowsToReposition)) {
+		shiftedRowsToReposition.insert(rowIndex >= bufferRowIndex ? rowIndex + 1 : rowIndex);
+	}
+	shiftedRowsToReposition.insert(bufferRowIndex);
+	rowsToReposition = shiftedRowsToReposition;
+}
+
+/**
+ * Removes a row from the buffer.
+ * 
+ * If the order buffer is to be adjusted, the row is removed from it as well, notifying the model
+ * if it was shown, and the buffer row indices stored in it are shifted accordingly.
+ * 
+ * @param bufferRowIndex	The buffer row index of the row to remove.
+ * @param adjustOrder		Whether to keep the order buffer in sync instead of rebuilding it later.
+ */
+void CompositeTable::removeBufferRow(BufferRowIndex bufferRowIndex, bool adjustOrder)
+{
+	if (!adjustOrder) {
+		buffer.removeRow(bufferRowIndex);
+		return;
+	}
+	
+	const ViewRowIndex viewRowIndex = viewOrder.findViewRowIndexForBufferRow(bufferRowIndex);
+	if (viewRowIndex.isValid()) {
+		beginRemoveRows(QModelIndex(), viewRowIndex.get(), viewRowIndex.get());
+		viewOrder.removeViewRow(viewRowIndex);
+	}
+	
+	buffer.removeRow(bufferRowIndex);
+	viewOrder.adjustForRemovedBufferRow(bufferRowIndex);
+	QSet<BufferRowIndex> shiftedRowsToReposition = QSet<BufferRowIndex>();
+	for (const BufferRowIndex& rowIndex : std::as_const(rowsToReposition)) {
+		if (rowIndex == bufferRowIndex) continue;
+		shiftedRowsToReposition.insert(rowIndex > bufferRowIndex ? rowIndex - 1 : rowIndex);
+	}
+	rowsToReposition = shiftedRowsToReposition;
+	
+	if (viewRowIndex.isValid()) {
+		endRemoveRows();
+	}
+}
+
+/**
+ * Returns the raw value of the given cell of a dirty column, computing it and storing it in the
+ * buffer if that has not been done since the column was marked dirty.
+ * 
+ * If the column is used for sorting or filtering and the cell changed, its row is scheduled to be
+ * repositioned in the order buffer.
+ * 
+ * @param bufferRowIndex	The buffer row index of the cell.
+ * @param column			The dirty column the cell belongs to. Must not have interdependent cells.
+ * @return					The up-to-date raw value of the cell.
+ */
+QVariant CompositeTable::computeCellOnDemand(BufferRowIndex bufferRowIndex, const CompositeColumn& column)
+{
+	assert(dirtyColumns.contains(&column) && !column.cellsAreInterdependent);
+	
+	auto iter = computedCellsInDirtyColumns.find(&column);
+	if (iter == computedCellsInDirtyColumns.end()) {
+		iter = computedCellsInDirtyColumns.insert(&column, BufferRowSelection(buffer.numRows(), false));
+	}
+	
+	const int columnIndex = column.getIndex();
+	if (!iter->contains(bufferRowIndex)) {
+		const QVariant newContent = computeCellContent(bufferRowIndex, columnIndex);
+		if (!orderBufferDirty && isUsedForOrder(&column) && buffer.getCell(bufferRowIndex, columnIndex) != newContent) {
+			rowsToReposition.insert(bufferRowIndex);
+		}
+		buffer.replaceCell(bufferRowIndex, columnIndex, newContent);
+		iter->select(bufferRowIndex);
+	}
+	
+	return buffer.getCell(bufferRowIndex, columnIndex);
+}
+
+/**
+ * Makes sure the cells of the given dirty column are computed for the given view row and, if that
+ * cell was not computed yet, for the rows around it, so that scrolling does not need to compute
+ * cells one by one.
+ * 
+ * @param column		The dirty column whose cells to compute. Must not have interdependent cells.
+ * @param viewRowIndex	The view row which is about to be shown.
+ */
+void CompositeTable::computeCellsAroundViewRow(const CompositeColumn& column, ViewRowIndex viewRowIndex)
+{
+	const BufferRowIndex bufferRowIndex = viewOrder.getBufferRowIndexForViewRow(viewRowIndex);
+	const auto iter = computedCellsInDirtyColumns.constFind(&column);
+	if (iter != computedCellsInDirtyColumns.constEnd() && iter->contains(bufferRowIndex)) return;
+	
+	const int firstViewRow	= std::max(0, viewRowIndex.get() - numRowsToComputeAroundShownRow);
+	const int lastViewRow	= std::min(viewOrder.numRows() - 1, viewRowIndex.get() + numRowsToComputeAroundShownRow);
+	for (int viewRow = firstViewRow; viewRow <= lastViewRow; viewRow++) {
+		computeCellOnDemand(viewOrder.getBufferRowIndexForViewRow(ViewRowIndex(viewRow)), column);
+	}
+}
+
+/**
+ * Computes the cells which were requested for display by data() since the last call, together with
+ * the rows around them, then notifies the model of the changed cells and repositions rows whose
+ * cells used for sorting or filtering changed.
+ * 
+ * Called through onDemandComputationTimer once control returns to the event loop, so that the
+ * buffer is not modified while the view is painting. Columns which are being computed in the
+ * background are skipped, their cells are shown once the background task has finished.
+ */
+void CompositeTable::computeCellsRequestedOnDemand()
+{
+	QHash<const CompositeColumn*, QSet<BufferRowIndex>> requestedCells = QHash<const CompositeColumn*, QSet<BufferRowIndex>>();
+	requestedCells.swap(cellsRequestedOnDemand);
+	if (!bufferInitialized) return;
+	
+	for (auto iter = requestedCells.constBegin(); iter != requestedCells.constEnd(); iter++) {
+		const CompositeColumn& column = *iter.key();
+		if (!dirtyColumns.contains(&column) || backgroundColumns.contains(&column)) continue;
+		
+		for (const BufferRowIndex& bufferRowIndex : iter.value()) {
+			if (bufferRowIndex.isInvalid(buffer.numRows())) continue;
+			const ViewRowIndex viewRowIndex = viewOrder.findViewRowIndexForBufferRow(bufferRowIndex);
+			if (viewRowIndex.isInvalid()) continue;
+			computeCellsAroundViewRow(column, viewRowIndex);
+		}
+		
+		const int columnIndex = column.getIndex();
+		QModelIndex topLeftIndex		= index(0, columnIndex);
+		QModelIndex bottomRightIndex	= index(viewOrder.numRows() - 1, columnIndex);
+		if (topLeftIndex.isValid() && bottomRightIndex.isValid()) {
+			Q_EMIT dataChanged(topLeftIndex, bottomRightIndex);
+		}
+	}
+	
+	repositionRows();
+}
+
+/**
+ * Determines whether cells of the given column can be computed one by one when they are shown
+ * while the column is dirty, instead of updating the whole column first.
+ * 
+ * This is not possible for columns with interdependent cells, and not sensible for columns which
+ * are computed much faster as a whole.
+ * 
+ * @param column	The column to check.
+ * @return			True if the column's cells can be computed on demand, false otherwise.
+ */
+bool CompositeTable::canBeComputedOnDemand(const CompositeColumn& column) const
+{
+	return !column.cellsAreInterdependent && !column.isComputedAsWholeColumn();
+}
+
+/**
+ * Discards the information which cells of the given dirty column have been computed on demand,
+ * since they may be outdated, and notifies the model so that the shown cells are computed again.
+ * 
+ * @param column	The dirty column whose buffered cells are outdated.
+ */
+void CompositeTable::resetCellsComputedOnDemand(const CompositeColumn& column)
+{
+	computedCellsInDirtyColumns.remove(&column);
+	
+	const int columnIndex = column.getIndex();
+	QModelIndex topLeftIndex		= index(0, columnIndex);
+	QModelIndex bottomRightIndex	= index(viewOrder.numRows() - 1, columnIndex);
+	if (topLeftIndex.isValid() && bottomRightIndex.isValid()) {
+		Q_EMIT dataChanged(topLeftIndex, bottomRightIndex);
+	}
+}
+
+/**
+ * Determines which rows of this table contain cells of the given column which are affected by the
+ * given changes, if this can be determined at row level.
+ * 
+ * Changes in the base table itself only affect the changed rows. Changes in other tables are
+ * mapped back to the base table by following the column's breadcrumb trail in reverse, starting at
+ * the changed rows. This is not possible for columns with interdependent cells, for changes in
+ * associative tables, for tables from which rows were removed (since the removed rows cannot be
+ * followed anymore), and for changed keys outside the base table (since the rows which referenced
+ * the previous key cannot be found anymore). In these cases, false is returned.
+ * 
+ * @param column						The composite column to check.
+ * @param affectedColumns				The database columns in which changes occurred.
+ * @param rowsAddedOrRemovedPerTable	The rows which were added or removed in each table, and whether they were added (true) or removed (false).
+ * @param changedRowsPerColumn			The rows in which existing cells were changed, for each affected database column.
+ * @param affectedBufferRows			The set to which the buffer row indices of all affected rows are added.
+ * @return								True if the affected rows could be determined, false if the whole column has to be recomputed.
+ */
+bool CompositeTable::findAffectedBufferRows(const CompositeColumn& column, const QSet<const Column*>& affectedColumns, const QHash<const Table*, QList<QPair<BufferRowIndex, bool>>>& rowsAddedOrRemovedPerTable, const QHash<const Column*, QSet<BufferRowIndex>>& changedRowsPerColumn, QSet<BufferRowIndex>& affectedBufferRows) const
+{
+	if (column.cellsAreInterdependent) return false;
+	
+	// Rows added to the base table always need to be computed
+	for (const auto& [bufferRowIndex, addedNotRemoved] : rowsAddedOrRemovedPerTable.value(&baseTable)) {
+		if (addedNotRemoved) affectedBufferRows.insert(bufferRowIndex);
+	}
+	
+	const Breadcrumbs* const breadcrumbs = column.getBreadcrumbs();
+	
+	QSet<const Table*> handledTables = QSet<const Table*>();
+	const QSet<const Column*> underlyingColumns = underlyingColumnsPerColumn.value(&column);
+	for (const Column* const underlyingColumn : underlyingColumns) {
+		if (!affectedColumns.contains(underlyingColumn)) continue;
+		
+		const Table& table = underlyingColumn->table;
+		const QSet<BufferRowIndex> changedRows = changedRowsPerColumn.value(underlyingColumn);
+		bool anyRowsRemovedFromTable = false;
+		for (const auto& [_, addedNotRemoved] : rowsAddedOrRemovedPerTable.value(&table)) {
+			if (!addedNotRemoved) anyRowsRemovedFromTable = true;
+		}
+		
+		if (&table == &baseTable) {
+			// Removed rows are gone from the buffer, but other row indices have shifted
+			if (anyRowsRemovedFromTable && !changedRows.isEmpty()) return false;
+			affectedBufferRows.unite(changedRows);
+			continue;
+		}
+		
+		if (table.isAssociative || anyRowsRemovedFromTable) return false;
+		if (underlyingColumn->isKey() && !changedRows.isEmpty()) return false;
+		if (!breadcrumbs || !breadcrumbs->reaches(table)) return false;
+		
+		// Collect changed and added rows in the other table
+		QSet<BufferRowIndex> startRows = changedRows;
+		if (!handledTables.contains(&table)) {
+			for (const auto& [bufferRowIndex, addedNotRemoved] : rowsAddedOrRemovedPerTable.value(&table)) {
+				if (addedNotRemoved) startRows.insert(bufferRowIndex);
+			}
+			handledTables.insert(&table);
+		}
+		if (startRows.isEmpty()) continue;
+		
+		// Follow the breadcrumb trail back to the base table
+		const Breadcrumbs reversedCrumbs = breadcrumbs->getReversedUpTo((const NormalTable&) table);
+		const BreadcrumbMapping mapping = reversedCrumbs.evaluateForRows(QList<BufferRowIndex>(startRows.constBegin(), startRows.constEnd()), false);
+		for (int startPosition = 0; startPosition < mapping.numStartRows(); startPosition++) {
+			const auto end = mapping.targetRowsEnd(startPosition);
+			for (auto iter = mapping.targetRowsBegin(startPosition); iter != end; iter++) {
+				affectedBufferRows.insert(*iter);
+			}
+		}
+	}
+	
+	return true;
+}
+
+/**
+ * Recomputes the cells of the given column in the given rows and writes them to the buffer.
+ * 
+ * @param column			The column whose cells to update.
+ * @param bufferRowIndices	The buffer row indices of the cells to update.
+ */
+void CompositeTable::updateBufferCells(const CompositeColumn& column, const QSet<BufferRowIndex>& bufferRowIndices)
+{
+	if (bufferRowIndices.isEmpty()) return;
+	
+	const int columnIndex = column.getIndex();
+	QHash<BufferRowIndex, QVariant> newContents = QHash<BufferRowIndex, QVariant>();
+	for (const BufferRowIndex& bufferRowIndex : bufferRowIndices) {
+		assert(bufferRowIndex.isValid(buffer.numRows()));
+		newContents.insert(bufferRowIndex, computeCellContent(bufferRowIndex, columnIndex));
+	}
+	
+	writeBufferCells(column, newContents);
+}
+
+/**
+ * Writes the given new contents for cells of the given column to the buffer and notifies the
+ * model of the changes.
+ * 
+ * Cells whose content does not actually change are skipped. If the column is used for sorting or
+ * filtering, the rows of all updated cells are scheduled to be repositioned in the order buffer.
+ * 
+ * @param column		The column whose cells to update.
+ * @param newContents	The new raw contents of the cells to update, by buffer row index.
+ */
+void CompositeTable::writeBufferCells(const CompositeColumn& column, const QHash<BufferRowIndex, QVariant>& newContents)
+{
+	const int columnIndex = column.getIndex();
+	const bool usedForOrder = isUsedForOrder(&column);
+	for (auto iter = newContents.constBegin(); iter != newContents.constEnd(); iter++) {
+		const BufferRowIndex& bufferRowIndex = iter.key();
+		assert(bufferRowIndex.isValid(buffer.numRows()));
+		const QVariant newContent = iter.value().isValid() ? iter.value() : QVariant();
+		if (buffer.getCell(bufferRowIndex, columnIndex) == newContent) continue;
+		buffer.replaceCell(bufferRowIndex, columnIndex, newContent);
+		if (usedForOrder && !orderBufferDirty) rowsToReposition.insert(bufferRowIndex);
+		
+		if (orderBufferDirty) continue;
+		const ViewRowIndex viewRowIndex = viewOrder.findViewRowIndexForBufferRow(bufferRowIndex);
+		if (viewRowIndex.isInvalid()) continue;
+		const QModelIndex modelIndex = index(viewRowIndex.get(), columnIndex);
+		if (modelIndex.isValid()) {
+			Q_EMIT dataChanged(modelIndex, modelIndex);
+		}
+	}
+}
+
 
 
 /**
@@ -907,6 +2047,9 @@ int CompositeTable::columnCount(const QModelIndex& parent) const
  * For horizontal headers, the section number corresponds to the column number. Similarly, for
  * vertical headers, the section number corresponds to the row number.
  * 
+ * Since the view's sort indicator only shows the primary sorting, columns used for secondary
+ * sortings are marked with an arrow for their order and their priority among all sorting passes.
+ * 
  * @param section		The index of the section to return the data for.
  * @param orientation	The orientation of the header (horizontal or vertical).
  * @param role			The Qt::ItemDataRole for which to return the data.
@@ -926,7 +2069,15 @@ QVariant CompositeTable::headerData(int section, Qt::Orientation orientation, in
 	if (role != Qt::DisplayRole) return QVariant();
 	
 	assert(section >= 0 && section < getNumberOfNormalColumns());
-	return getColumnAt(section).uiName;
+	const CompositeColumn& column = getColumnAt(section);
+	
+	for (int i = 0; i < secondarySortings.size(); i++) {
+		const SortingPass& sorting = secondarySortings.at(i);
+		if (sorting.column != &column) continue;
+		const QChar arrow = sorting.order == Qt::AscendingOrder ? QChar(0x25B2) : QChar(0x25BC);
+		return column.uiName + "  " + arrow + QString::number(i + 2);
+	}
+	return column.uiName;
 }
 
 /**
@@ -937,6 +2088,9 @@ QVariant CompositeTable::headerData(int section, Qt::Orientation orientation, in
  * boolean values can be displayed as checkboxes using the Qt::CheckStateRole. Alignment is also
  * defined here.
  * 
+ * Cells of dirty columns which have not been computed yet are returned empty and requested to be
+ * computed once control returns to the event loop (see computeCellsRequestedOnDemand()).
+ * 
  * @param index	The model index to return the data for. Assumed to have no valid parent.
  * @param role	The Qt::ItemDataRole for which to return the data.
  * @return		The data for the given role and index in the table.
@@ -963,6 +2117,19 @@ QVariant CompositeTable::data(const QModelIndex& index, int role) const
 	const int relevantRole = column.contentType == Bit ? Qt::CheckStateRole : Qt::DisplayRole;
 	if (role != relevantRole) return QVariant();
 	
+	if (dirtyColumns.contains(&column) && canBeComputedOnDemand(column)) {
+		const auto iter = computedCellsInDirtyColumns.constFind(&column);
+		if (iter == computedCellsInDirtyColumns.constEnd() || !iter->contains(bufferRowIndex)) {
+			// Cell is shown empty until it is computed outside of painting
+			cellsRequestedOnDemand[&column].insert(bufferRowIndex);
+			onDemandComputationTimer.start();
+			return QVariant();
+		}
+	}
+	
+	const QVariant cachedFormatted = buffer.getCachedFormattedCell(bufferRowIndex, columnIndex);
+	if (cachedFormatted.isValid()) return cachedFormatted;
+	
 	const QVariant result = buffer.getCell(bufferRowIndex, columnIndex);
 	
 	if (result.isNull()) return QVariant();
@@ -972,14 +2139,19 @@ QVariant CompositeTable::data(const QModelIndex& index, int role) const
 		return result.toBool() ? Qt::Checked : Qt::Unchecked;
 	}
 	
-	return column.toFormattedTableContent(result);
+	// Cache formatted value until the cell changes, so that repainting does not format it again
+	const QVariant formatted = column.toFormattedTableContent(result);
+	buffer.cacheFormattedCell(bufferRowIndex, columnIndex, formatted);
+	return formatted;
 }
 
 /**
  * For the QAbstractItemModel implementation, sorts the table by the given column and order.
  * 
  * This function is called by the view when the user clicks on a column header to sort by that
- * column. It looks up the column which was clicked and delegates the sorting to performSort().
+ * column. It looks up the column which was clicked and delegates the sorting to setSorting().
+ * Secondary sortings are kept if only the order of the current sorting changes and discarded
+ * otherwise.
  * 
  * @param columnIndex	The index of the visible column to sort by.
  * @param order			The order to sort by (ascending or descending).
@@ -989,33 +2161,28 @@ void CompositeTable::sort(int columnIndex, Qt::SortOrder order)
 	assert(columnIndex >= 0 && columnIndex < getNumberOfNormalColumns());
 	const CompositeColumn& column = getColumnAt(columnIndex);
 	
-	if (bufferInitialized) updateBufferColumns({ &column });	// Sort column might need to be updated if hidden
-	
-	const SortingPass previousSort = currentSorting;
-	currentSorting = {&column, order};
-	
-	// Remember horizontal scroll
-	const int horizontalScroll = tableView->horizontalScrollBar()->value();
-	
-	performSort(previousSort, true);
-	
-	// Restore horizontal scroll and emit signal
-	tableView->horizontalScrollBar()->setValue(horizontalScroll);
-	Q_EMIT wasResorted();
+	QList<SortingPass> sortingPasses = { {&column, order} };
+	if (&column == currentSorting.column) {
+		sortingPasses.append(secondarySortings);
+	}
+	setSorting(sortingPasses);
 }
 
 /**
- * Sorts the visible rows in the table by the given column and order.
+ * Sorts the visible rows in the table by all passes of the current sorting.
+ * 
+ * The sort keys of all passes are extracted once and the rows are sorted in a single stable sort
+ * which compares the keys of each pass in turn.
  * 
- * Once the table is initialized, the table does not need to be resorted from scratch if the column
- * to sort by does not change (i.e., it is the same as in the current sorting). Then, either
- * nothing needs to be done if the order is *also* the same as in the current sorting, or the order
- * can simply be reversed if the order is opposite to the current sorting.
+ * Once the table is initialized, the table does not need to be resorted from scratch if the
+ * sorting passes do not change (i.e., they are the same as before). Then, either nothing needs to
+ * be done if the orders are *also* the same as before, or, if the table is sorted by a single
+ * column, the order can simply be reversed if it is opposite to the previous sorting.
  * 
- * @param previousSort			The column and order the table was sorted by before this call.
+ * @param previousSorting		The sorting passes the table was sorted by before this call.
  * @param allowPassAndReverse	Whether to allow shortcuts in resorting. Do not use on initial sort.
  */
-void CompositeTable::performSort(SortingPass previousSort, bool allowPassAndReverse)
+void CompositeTable::performSort(const QList<SortingPass>& previousSorting, bool allowPassAndReverse)
 {
 	assert(currentSorting.column);
 	assert(tableView);
@@ -1026,24 +2193,29 @@ void CompositeTable::performSort(SortingPass previousSort, bool allowPassAndReve
 	ViewRowIndex previouslySelectedViewRowIndex = ViewRowIndex(tableView->currentIndex().row());
 	BufferRowIndex previouslySelectedBufferRowIndex = getBufferRowIndexForViewRow(previouslySelectedViewRowIndex);
 	
-	if (allowPassAndReverse && currentSorting.column == previousSort.column) {
-		if (currentSorting.order == previousSort.order) return;
+	const QList<SortingPass> sortingPasses = getCurrentSortingPasses();
+	bool sameColumns = previousSorting.size() == sortingPasses.size();
+	bool sameOrders = sameColumns;
+	for (int i = 0; sameColumns && i < sortingPasses.size(); i++) {
+		sameColumns &= sortingPasses.at(i).column == previousSorting.at(i).column;
+		sameOrders &= sortingPasses.at(i).order == previousSorting.at(i).order;
+	}
+	
+	if (allowPassAndReverse && sameColumns && (sameOrders || sortingPasses.size() == 1)) {
+		if (sameOrders) return;
 		
 		viewOrder.reverse();
 	}
 	else {
-		auto comparator = [this](const BufferRowIndex& index1, const BufferRowIndex& index2) {
-			QVariant value1 = currentSorting.column->getRawValueAt(index1);
-			QVariant value2 = currentSorting.column->getRawValueAt(index2);
-			
-			if (currentSorting.order == Qt::AscendingOrder) {
-				return currentSorting.column->compare(value1, value2);
-			} else {
-				return currentSorting.column->compare(value2, value1);
-			}
-		};
-		
-		viewOrder.sortBy(comparator);
+		// Extract sort keys once instead of reading and comparing cells for every comparison
+		const QList<BufferRowIndex>& bufferRowIndices = viewOrder.getBufferRowIndices();
+		QList<QList<qint64>> sortKeys = QList<QList<qint64>>();
+		QList<Qt::SortOrder> sortOrders = QList<Qt::SortOrder>();
+		for (const auto& [column, order] : sortingPasses) {
+			sortKeys.append(column->getSortKeys(bufferRowIndices));
+			sortOrders.append(order);
+		}
+		viewOrder.sortByKeys(sortKeys, sortOrders);
 	}
 	
 	// Restore selection
@@ -1088,7 +2260,8 @@ QVariant CompositeTable::computeCellContent(BufferRowIndex bufferRowIndex, int c
 /**
  * Computes the value of all cells in the column together.
  * 
- * Used for composite columns with interdependent cells, such as IndexCompositeColumn.
+ * Used for composite columns with interdependent cells, such as IndexCompositeColumn, and for
+ * columns which can be computed faster as a whole, such as FoldCompositeColumn.
  * 
  * @param columnIndex	The index of the column to compute the values for.
  * @return				The list of all computed raw values for the cells in the column.
@@ -1101,6 +2274,127 @@ QList<QVariant> CompositeTable::computeWholeColumnContent(int columnIndex) const
 	return cells;
 }
 
+/**
+ * Computes the contents of all cells in the given columns, distributing the work across a pool of
+ * worker threads.
+ * 
+ * Columns which are computed cell by cell are split into chunks of rows, each of which is computed
+ * by a separate task. Columns which have to be computed as a whole are computed by a single task
+ * each. The results are collected separately and not written to the buffer, which is left to the
+ * caller. During computation, the base tables must not be modified.
+ * 
+ * While waiting for the workers to finish, the given progress function is called regularly on the
+ * calling thread with the total number of cells computed so far.
+ * 
+ * @param columnsToCompute	The columns to compute.
+ * @param reportProgress	A function to call with the number of computed cells whenever progress is made.
+ * @return					The computed raw values of all cells, in a list per column in the order of the given columns.
+ */
+QList<QList<QVariant>> CompositeTable::computeColumnsInParallel(const QList<const CompositeColumn*>& columnsToCompute, std::function<void (int)> reportProgress) const
+{
+	const int numberOfRows = baseTable.getNumberOfRows();
+	QList<QList<QVariant>> results = QList<QList<QVariant>>(columnsToCompute.size());
+	if (columnsToCompute.isEmpty()) return results;
+	
+	QThreadPool pool;
+	std::atomic<int> numCellsComputed(0);
+	// Aim for a few tasks per thread to balance load, but avoid tiny tasks
+	const int rowsPerTask = std::max(256, numberOfRows / (std::max(1, pool.maxThreadCount()) * 4) + 1);
+	
+	for (int i = 0; i < columnsToCompute.size(); i++) {
+		const CompositeColumn* const column = columnsToCompute.at(i);
+		const int columnIndex = column->getIndex();
+		QList<QVariant>& columnResults = results[i];
+		
+		if (column->isComputedAsWholeColumn()) {
+			pool.start([this, columnIndex, numberOfRows, &columnResults, &numCellsComputed] () {
+				columnResults = computeWholeColumnContent(columnIndex);
+				numCellsComputed += numberOfRows;
+			});
+			continue;
+		}
+		
+		// Allocate result list up front so that each task can write to its own range
+		columnResults = QList<QVariant>(numberOfRows, QVariant());
+		QVariant* const cells = columnResults.data();
+		for (int firstRow = 0; firstRow < numberOfRows; firstRow += rowsPerTask) {
+			const int endRow = std::min(firstRow + rowsPerTask, numberOfRows);
+			pool.start([this, columnIndex, cells, firstRow, endRow, &numCellsComputed] () {
+				for (int row = firstRow; row < endRow; row++) {
+					cells[row] = computeCellContent(BufferRowIndex(row), columnIndex);
+				}
+				numCellsComputed += endRow - firstRow;
+			});
+		}
+	}
+	
+	// Wait for all tasks to finish, reporting progress in between
+	while (!pool.waitForDone(50)) {
+		if (reportProgress) reportProgress(numCellsComputed);
+	}
+	if (reportProgress) reportProgress(numCellsComputed);
+	
+	return results;
+}
+
+/**
+ * Writes the results of all finished background tasks to the buffer and notifies the model of the
+ * changes.
+ * 
+ * If any of the written columns is used for sorting or filtering, or if the order buffer is still
+ * dirty once all background tasks are done, the order buffer is rebuilt. Results for columns which
+ * have been updated by other means in the meantime are discarded.
+ */
+void CompositeTable::applyFinishedBackgroundResults()
+{
+	QList<QPair<const CompositeColumn*, QList<QVariant>>> results = QList<QPair<const CompositeColumn*, QList<QVariant>>>();
+	{
+		QMutexLocker locker(&backgroundMutex);
+		results.swap(finishedBackgroundResults);
+	}
+	if (results.isEmpty()) return;
+	
+	bool rebuildOrder = false;
+	for (const auto& [column, cells] : std::as_const(results)) {
+		backgroundColumns.remove(column);
+		if (!dirtyColumns.contains(column)) continue;
+		
+		const int columnIndex = column->getIndex();
+		assert(cells.size() == buffer.numRows());
+		for (BufferRowIndex bufferRowIndex = BufferRowIndex(0); bufferRowIndex.isValid(buffer.numRows()); bufferRowIndex++) {
+			buffer.replaceCell(bufferRowIndex, columnIndex, cells.at(bufferRowIndex.get()));
+		}
+		dirtyColumns.remove(column);
+		computedCellsInDirtyColumns.remove(column);
+		
+		QModelIndex topLeftIndex		= index(0, columnIndex);
+		QModelIndex bottomRightIndex	= index(viewOrder.numRows() - 1, columnIndex);
+		if (topLeftIndex.isValid() && bottomRightIndex.isValid()) {
+			Q_EMIT dataChanged(topLeftIndex, bottomRightIndex);
+		}
+		
+		rebuildOrder |= isUsedForSorting(column);
+		for (const Filter* const filter : std::as_const(currentFilters)) {
+			rebuildOrder |= column == &filter->columnToFilterBy;
+		}
+	}
+	
+	rebuildOrder |= orderBufferDirty && backgroundColumns.isEmpty();
+	if (rebuildOrder) {
+		rebuildOrderBuffer(false);
+	} else {
+		repositionRows();
+	}
+	
+	if (backgroundColumns.isEmpty()) {
+		if (tableToAutoResizeAfterCompute) {
+			tableToAutoResizeAfterCompute->resizeColumnsToContents();
+			tableToAutoResizeAfterCompute = nullptr;
+		}
+		Q_EMIT backgroundUpdateFinished();
+	}
+}
+
 
 
 /**
@@ -29,6 +29,9 @@
 
 #include <QTableView>
 #include <QProgressDialog>
+#include <QMutex>
+#include <QTimer>
+#include <QWaitCondition>
 
 class Filter;
 
@@ -53,13 +56,18 @@ struct SortingPass {
  * depends on the kind of CompositeColumn it is). A buffer is used to store all computed values.
  * However, the buffered values are not necessarily in their final form in which they are to be
  * displayed in the UI. The buffer stores "raw" computed values, which have to be formatted before
- * being shown in the UI, which is done on the fly in CompositeColumn::toFormattedTableContent().
+ * being shown in the UI, which is done in CompositeColumn::toFormattedTableContent(). Formatted
+ * values are cached in the buffer alongside the raw values until the respective cell changes.
+ * Columns which show a base table column unchanged are not computed at all. Instead, the buffer
+ * reads their cells directly from the buffer of the base table.
  * 
  * To make sure the buffer stays up to date, the CompositeTable must be notified of any changes in
  * the underlying data in the database. For this purpose, there is a change annunciation mechanism.
  * Depending on a user setting, the table can either be updated immediately or only once it is
  * actually needed. In the latter case, the affected columns are marked as dirty and their update
  * deferred.
+ * Dirty columns can also be computed in the background, in which case they are written to the
+ * buffer as they become ready, and sorting or filtering by them is deferred until then.
  * 
  * The CompositeTable is also responsible for sorting and filtering its content. For controlling
  * which rows are actually displayed and in which order, a ViewOrderBuffer is used. This buffer is
@@ -94,6 +102,10 @@ private:
 	QStringList staticColumnNames;
 	/** The names of the current custom columns. */
 	QStringList customColumnNames;
+	/** For each database column, the normal and custom composite columns whose contents depend on it. Rebuilt whenever the set of columns changes. */
+	QHash<const Column*, QSet<const CompositeColumn*>> dependentColumnsPerUnderlyingColumn;
+	/** For each normal and custom composite column, the database columns its contents depend on. Rebuilt together with dependentColumnsPerUnderlyingColumn. */
+	QHash<const CompositeColumn*, QSet<const Column*>> underlyingColumnsPerColumn;
 	
 	/** Whether the buffer has been initialized for an open project. */
 	bool bufferInitialized;
@@ -103,21 +115,51 @@ private:
 	ViewOrderBuffer viewOrder;
 	/** The currently applied sorting, as a pair of the column to sort by and the sort order. */
 	SortingPass currentSorting;
+	/** Additional sortings which break ties in the current sorting, in order of decreasing priority. */
+	QList<SortingPass> secondarySortings;
 	/** The set of currently applied filters. */
 	QList<const Filter*> currentFilters;
 	
 	/** The current set of dirty columns which need to be updated before reading the buffer. */
 	QSet<const CompositeColumn*> dirtyColumns;
+	/** For dirty columns, which cells have already been computed on demand and are up to date in the buffer. */
+	QHash<const CompositeColumn*, BufferRowSelection> computedCellsInDirtyColumns;
+	/** Whether the order buffer needs to be rebuilt because rows were added or removed or values used for sorting or filtering changed. */
+	bool orderBufferDirty;
+	/** Whether a sorting was set while one of its columns was computed in the background, so that wasResorted() still has to be emitted once it is applied. */
+	bool deferredSortPending;
+	/** Buffer rows which may have to be inserted into, moved within or removed from the order buffer because they were added or values used for sorting or filtering changed. Only used while the order buffer is not dirty. */
+	QSet<BufferRowIndex> rowsToReposition;
 	/** The set of columns which are currently hidden and therefore do not need to be updated unless they are used for sorting and/or filtering. */
 	QSet<const CompositeColumn*> hiddenColumns;
 	/** Whether the table is currently set to update its columns immediately when notified of changes in the database. */
 	bool updateImmediately;
 	/** A pointer to the UI table view which, if set, is automatically resized after the buffer is computed. */
 	QTableView* tableToAutoResizeAfterCompute;
+	/** Cells of dirty columns which were requested by data() but not computed yet, per column. */
+	mutable QHash<const CompositeColumn*, QSet<BufferRowIndex>> cellsRequestedOnDemand;
+	/** Single-shot timer which computes the cells requested on demand once control returns to the event loop. */
+	mutable QTimer onDemandComputationTimer;
+	
+	/** The columns which are currently being computed in the background. */
+	QSet<const CompositeColumn*> backgroundColumns;
+	/** Guards numRunningBackgroundTasks and finishedBackgroundResults, which are shared with worker threads. */
+	QMutex backgroundMutex;
+	/** Signalled by worker threads whenever a background task finishes. */
+	QWaitCondition backgroundTaskFinished;
+	/** The number of background tasks which have not finished yet. */
+	int numRunningBackgroundTasks;
+	/** Results of finished background tasks which have not been written to the buffer yet. */
+	QList<QPair<const CompositeColumn*, QList<QVariant>>> finishedBackgroundResults;
 	
 	/** The change listener for all changes under this composite table. */
 	TableChangeListenerCompositeTable changeListener;
 	
+	/** The maximum number of scheduled rows which are repositioned one by one instead of rebuilding the order buffer. */
+	static const int maxRowsToRepositionIndividually;
+	/** The number of rows before and after a shown row whose cells are computed together with it on demand. */
+	static const int numRowsToComputeAroundShownRow;
+	
 public:
 	/** The internal name of the table (not for display in the UI). */
 	const QString name;
@@ -156,22 +198,45 @@ public:
 	int getIndexOf(const CompositeColumn& column) const;
 	int getExportIndexOf(const CompositeColumn& column) const;
 	QSet<QString> getNormalColumnNameSet() const;
+private:
+	void rebuildColumnDependencies();
+	QSet<const CompositeColumn*> getColumnsDependingOn(const QSet<const Column*>& underlyingColumns) const;
+public:
+	// Debugging
+	void printColumnDependencies() const;
 	
 	int getNumberOfCellsToInit() const;
 	void initBuffer(QProgressDialog* progressDialog, bool deferCompute = false, QTableView* tableToAutoResizeAfterCompute = nullptr);
+private:
+	void shareBufferColumnWithBaseTable(const CompositeColumn& column);
+public:
 	void rebuildOrderBuffer(bool skipRepopulate = false);
 	QSet<const CompositeColumn*> getColumnsToUpdate() const;
 	int getNumberOfCellsToUpdate() const;
 	void updateBufferColumns(QSet<const CompositeColumn*> columnsToUpdate, std::function<void()> runAfterEachCellUpdate = []() {});
+private:
+	void writeComputedColumns(const QList<const CompositeColumn*>& computedColumns, const QList<QList<QVariant>>& cellsPerColumn);
+public:
 	void updateBothBuffers(std::function<void()> runAfterEachCellUpdate = []() {});
+	int getNumberOfDirtyCellsFromWorkerThread();
+	void updateAllColumnsFromWorkerThread(std::function<void()> runAfterEachCellUpdate);
+	void updateBothBuffersInBackground();
+	void waitForBackgroundUpdate();
+	void waitForBackgroundTasks();
 	BufferRowIndex getBufferRowIndexForViewRow(ViewRowIndex viewRowIndex) const;
 	ViewRowIndex findViewRowIndexForBufferRow(BufferRowIndex bufferRowIndex) const;
 	
 	QVariant getRawValue(BufferRowIndex bufferRowIndex, const CompositeColumn& column);
 	QVariant getFormattedValue(BufferRowIndex bufferRowIndex, const CompositeColumn& column);
+	bool getIntegerBufferColumn(const CompositeColumn& column, const QList<qint32>*& values, const std::vector<bool>*& nullFlags) const;
+	bool getBitBufferColumn(const CompositeColumn& column, const std::vector<bool>*& bits) const;
+	bool getStringBufferColumn(const CompositeColumn& column, const QString*& arena, const QList<qint32>*& offsets, const QList<qint32>*& lengths, const std::vector<bool>*& nullFlags) const;
 	
 	virtual SortingPass getDefaultSorting() const = 0;
 	SortingPass getCurrentSorting() const;
+	QList<SortingPass> getCurrentSortingPasses() const;
+	void setSorting(const QList<SortingPass>& sortingPasses);
+	void addSecondarySorting(int columnIndex, Qt::SortOrder defaultOrder);
 	
 	// Filters
 	void setInitialFilters(const QList<const Filter*>& filters);
@@ -187,8 +252,21 @@ public:
 	void markAllColumnsUnhidden();
 	bool isColumnHidden(const CompositeColumn& column) const;
 	// Change annunciation
-	void setUpdateImmediately(bool updateImmediately, QProgressDialog* progress = nullptr);
-	void announceChanges(const QSet<const Column*>& affectedColumns, const QList<QPair<BufferRowIndex, bool>>& rowsAddedOrRemoved);
+	void setUpdateImmediately(bool updateImmediately);
+	void announceChanges(const QSet<const Column*>& affectedColumns, const QHash<const Table*, QList<QPair<BufferRowIndex, bool>>>& rowsAddedOrRemovedPerTable, const QHash<const Column*, QSet<BufferRowIndex>>& changedRowsPerColumn);
+private:
+	void insertBufferRow(BufferRowIndex bufferRowIndex, bool adjustOrder);
+	void removeBufferRow(BufferRowIndex bufferRowIndex, bool adjustOrder);
+	void announceChangesInSharedColumn(const CompositeColumn& column, const QSet<BufferRowIndex>& changedBufferRows, bool anyRowsRemoved);
+	QVariant computeCellOnDemand(BufferRowIndex bufferRowIndex, const CompositeColumn& column);
+	void computeCellsAroundViewRow(const CompositeColumn& column, ViewRowIndex viewRowIndex);
+	void computeCellsRequestedOnDemand();
+	bool canBeComputedOnDemand(const CompositeColumn& column) const;
+	void resetCellsComputedOnDemand(const CompositeColumn& column);
+	bool findAffectedBufferRows(const CompositeColumn& column, const QSet<const Column*>& affectedColumns, const QHash<const Table*, QList<QPair<BufferRowIndex, bool>>>& rowsAddedOrRemovedPerTable, const QHash<const Column*, QSet<BufferRowIndex>>& changedRowsPerColumn, QSet<BufferRowIndex>& affectedBufferRows) const;
+	void updateBufferCells(const CompositeColumn& column, const QSet<BufferRowIndex>& bufferRowIndices);
+	void writeBufferCells(const CompositeColumn& column, const QHash<BufferRowIndex, QVariant>& newContents);
+public:
 	
 	// QAbstractTableModel implementation
 	int rowCount(const QModelIndex& parent = QModelIndex()) const override;
@@ -197,10 +275,18 @@ public:
 	QVariant data(const QModelIndex& index, int role = Qt::DisplayRole) const override;
 	void sort(int columnIndex, Qt::SortOrder order = Qt::AscendingOrder) override;
 private:
-	void performSort(SortingPass previousSort, bool allowPassAndReverse);
+	void performSort(const QList<SortingPass>& previousSorting, bool allowPassAndReverse);
+	bool isUsedForSorting(const CompositeColumn* column) const;
+	bool isUsedForOrder(const CompositeColumn* column) const;
+	
+	void repositionRows();
+	bool passesFilters(BufferRowIndex bufferRowIndex) const;
+	static bool isSortedBefore(BufferRowIndex bufferRowIndex1, BufferRowIndex bufferRowIndex2, const QList<QList<qint64>>& sortKeysByBufferRow, const QList<Qt::SortOrder>& sortOrders);
 	
 	QVariant computeCellContent(BufferRowIndex bufferRowIndex, int columnIndex) const;
 	QList<QVariant> computeWholeColumnContent(int columnIndex) const;
+	QList<QList<QVariant>> computeColumnsInParallel(const QList<const CompositeColumn*>& columnsToCompute, std::function<void (int)> reportProgress) const;
+	void applyFinishedBackgroundResults();
 	
 public:
 	Breadcrumbs crumbsTo(const NormalTable& destinationTable) const;
@@ -212,6 +298,11 @@ signals:
 	 * Emitted after the table was resorted.
 	 */
 	void wasResorted();
+	/**
+	 * Emitted after all columns which were being computed in the background have been written to
+	 * the buffer.
+	 */
+	void backgroundUpdateFinished();
 };
 
 
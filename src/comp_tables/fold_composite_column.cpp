@@ -79,6 +79,91 @@ QSet<ValidItemID> FoldCompositeColumn::computeIDsAt(BufferRowIndex rowIndex) con
 	return ids;
 }
 
+/**
+ * Returns the table whose IDs computeIDsAt() returns, which is the target table.
+ * 
+ * @return	The target table of the breadcrumb trail.
+ */
+const NormalTable& FoldCompositeColumn::getIDTable() const
+{
+	return breadcrumbs.getTargetTable();
+}
+
+/**
+ * For each of the given rows, finds the rows in the target table whose IDs computeIDsAt() would
+ * return, by evaluating the breadcrumb trail for all rows at once.
+ * 
+ * @param rowIndices	The buffer row indices in the base table.
+ * @return				The mapping from each given row to the associated rows in the target table.
+ */
+BreadcrumbMapping FoldCompositeColumn::mapRowsToIDTable(const QList<BufferRowIndex>& rowIndices) const
+{
+	return breadcrumbs.evaluateForRows(rowIndices, false);
+}
+
+/**
+ * Computes the value of the cell at the given row index.
+ * 
+ * Evaluates the breadcrumb trail for the given row and delegates folding to fold().
+ * 
+ * @param rowIndex	The row index.
+ * @return			The computed value of the cell.
+ */
+QVariant FoldCompositeColumn::computeValueAt(BufferRowIndex rowIndex) const
+{
+	const QSet<BufferRowIndex> targetRowIndexSet = breadcrumbs.evaluate(rowIndex);
+	return fold(QList<BufferRowIndex>(targetRowIndexSet.constBegin(), targetRowIndexSet.constEnd()));
+}
+
+/**
+ * Computes the values of all cells in the column together.
+ * 
+ * Evaluates the breadcrumb trail for all rows of the base table at once, then folds the target
+ * rows for each row using fold().
+ * 
+ * @return	Computed values for all cells in the column.
+ */
+QList<QVariant> FoldCompositeColumn::computeWholeColumn() const
+{
+	const BreadcrumbMapping mapping = evaluateForAllBaseRows();
+	
+	QList<QVariant> cells = QList<QVariant>();
+	cells.reserve(mapping.numStartRows());
+	for (int startPosition = 0; startPosition < mapping.numStartRows(); startPosition++) {
+		cells.append(fold(mapping.getTargetRowsFor(startPosition)));
+	}
+	return cells;
+}
+
+/**
+ * Evaluates the breadcrumb trail for every row of the base table, without duplicates.
+ * 
+ * @return	The mapping from each buffer row index in the base table to its target rows.
+ */
+BreadcrumbMapping FoldCompositeColumn::evaluateForAllBaseRows() const
+{
+	const int numRows = table.baseTable.getNumberOfRows();
+	QList<BufferRowIndex> allRows = QList<BufferRowIndex>();
+	allRows.reserve(numRows);
+	for (BufferRowIndex rowIndex = BufferRowIndex(0); rowIndex.isValid(numRows); rowIndex++) {
+		allRows.append(rowIndex);
+	}
+	return breadcrumbs.evaluateForRows(allRows, false);
+}
+
+/**
+ * Indicates whether the buffer contents for this column should be computed all at once.
+ * 
+ * Fold columns are always computed as a whole, since evaluating the breadcrumb trail for all rows
+ * together is much faster than evaluating it separately for each row.
+ * 
+ * @return	True.
+ */
+bool FoldCompositeColumn::isComputedAsWholeColumn() const
+{
+	return true;
+}
+
 
 
 /**
@@ -96,6 +181,16 @@ const QSet<const Column*> FoldCompositeColumn::getAllUnderlyingColumns() const
 	return result;
 }
 
+/**
+ * Returns the breadcrumb trail which leads from the base table to the content table.
+ * 
+ * @return	A pointer to the breadcrumb trail of this column.
+ */
+const Breadcrumbs* FoldCompositeColumn::getBreadcrumbs() const
+{
+	return &breadcrumbs;
+}
+
 
 
 
@@ -107,10 +202,29 @@ CountFoldCompositeColumn::CountFoldCompositeColumn(CompositeTable& table, QStrin
 
 
 
-QVariant CountFoldCompositeColumn::computeValueAt(BufferRowIndex rowIndex) const
+/**
+ * Computes the values of all cells in the column together.
+ * 
+ * Evaluates the breadcrumb trail for all rows of the base table at once and reads the count for
+ * each base row directly from the evaluation result.
+ * 
+ * @return	Computed values for all cells in the column.
+ */
+QList<QVariant> CountFoldCompositeColumn::computeWholeColumn() const
 {
-	const QSet<BufferRowIndex> targetRowIndexSet = breadcrumbs.evaluate(rowIndex);
-	return targetRowIndexSet.size();
+	const BreadcrumbMapping mapping = evaluateForAllBaseRows();
+	
+	QList<QVariant> cells = QList<QVariant>();
+	cells.reserve(mapping.numStartRows());
+	for (int startPosition = 0; startPosition < mapping.numStartRows(); startPosition++) {
+		cells.append(mapping.numTargetRowsFor(startPosition));
+	}
+	return cells;
+}
+
+QVariant CountFoldCompositeColumn::fold(QList<BufferRowIndex> targetRowIndices) const
+{
+	return targetRowIndices.size();
 }
 
 
@@ -160,57 +274,103 @@ NumericFoldCompositeColumn::NumericFoldCompositeColumn(CompositeTable& table, QS
 
 
 /**
- * Computes the value of the cell at the given row index.
+ * Computes the values of all cells in the column together.
  * 
- * Delegates breadcrumb evaluation to FoldCompositeColumn::evaluateBreadcrumbTrail().
+ * Evaluates the breadcrumb trail for all rows of the base table at once, reads each content value
+ * which is reached at most once, then aggregates the values for every base row in a single linear
+ * pass over the evaluation result. Empty content cells are skipped.
  * 
- * @param rowIndex	The row index.
- * @return			The computed value of the cell.
+ * @return	Computed values for all cells in the column.
  */
-QVariant NumericFoldCompositeColumn::computeValueAt(BufferRowIndex rowIndex) const
+QList<QVariant> NumericFoldCompositeColumn::computeWholeColumn() const
 {
-	QSet<BufferRowIndex> rowIndexSet = breadcrumbs.evaluate(rowIndex);
-	
-	if (Q_UNLIKELY(rowIndexSet.isEmpty())) return QVariant();
+	const BreadcrumbMapping mapping = evaluateForAllBaseRows();
 	
-	int aggregate = 0;
-	if (op == MaxFold)	aggregate = INT_MIN;
-	if (op == MinFold)	aggregate = INT_MAX;
+	// Content values are read when first reached, since many content rows may never be
+	enum ContentState : char { Unread, Empty, Read };
+	const int numContentRows = contentTable->getNumberOfRows();
+	QList<int> contentValues = QList<int>(numContentRows, 0);
+	QList<ContentState> contentStates = QList<ContentState>(numContentRows, Unread);
 	
-	for (const BufferRowIndex& rowIndex : std::as_const(rowIndexSet)) {
-		QVariant content = contentColumn->getValueAt(rowIndex);
-		
-		switch (op) {
-		case AverageFold:
-		case SumFold:
-			assert(content.canConvert<int>());
-			aggregate += content.toInt();
-			break;
-		case MaxFold:
-			assert(content.canConvert<int>());
-			aggregate = std::max(aggregate, content.toInt());
-			break;
-		case MinFold:
-			assert(content.canConvert<int>());
-			aggregate = std::min(aggregate, content.toInt());
-			break;
-		default:
-			assert(false);
+	// Aggregate values for every base row
+	QList<QVariant> cells = QList<QVariant>();
+	cells.reserve(mapping.numStartRows());
+	for (int startPosition = 0; startPosition < mapping.numStartRows(); startPosition++) {
+		Aggregate aggregate = Aggregate();
+		const auto end = mapping.targetRowsEnd(startPosition);
+		for (auto iter = mapping.targetRowsBegin(startPosition); iter != end; iter++) {
+			const int contentRow = iter->get();
+			if (contentStates.at(contentRow) == Unread) {
+				const QVariant content = contentColumn->getValueAt(*iter);
+				if (content.isValid()) {
+					assert(content.canConvert<int>());
+					contentValues[contentRow] = content.toInt();
+					contentStates[contentRow] = Read;
+				} else {
+					contentStates[contentRow] = Empty;
+				}
+			}
+			if (contentStates.at(contentRow) == Empty) continue;
+			aggregate.add(contentValues.at(contentRow));
 		}
+		cells.append(getResultFor(aggregate));
 	}
-	
-	assert(!rowIndexSet.isEmpty());
+	return cells;
+}
+
+/**
+ * Folds the given target rows into a single value using the fold operation of this column.
+ * 
+ * Empty content cells are skipped.
+ * 
+ * @param targetRowIndices	The buffer row indices in the content table to fold.
+ * @return					The folded value, or an invalid QVariant if there are no values to fold.
+ */
+QVariant NumericFoldCompositeColumn::fold(QList<BufferRowIndex> targetRowIndices) const
+{
+	Aggregate aggregate = Aggregate();
+	for (const BufferRowIndex& rowIndex : std::as_const(targetRowIndices)) {
+		const QVariant content = contentColumn->getValueAt(rowIndex);
+		if (!content.isValid()) continue;
+		assert(content.canConvert<int>());
+		aggregate.add(content.toInt());
+	}
+	return getResultFor(aggregate);
+}
+
+/**
+ * Returns the result of the fold operation of this column for the given aggregate.
+ * 
+ * @param aggregate	The aggregate of all values to fold.
+ * @return			The folded value, or an invalid QVariant if no values were aggregated.
+ */
+QVariant NumericFoldCompositeColumn::getResultFor(const Aggregate& aggregate) const
+{
+	if (Q_UNLIKELY(aggregate.count == 0)) return QVariant();
 	
 	switch (op) {
-	case AverageFold:	return std::round((qreal) aggregate / rowIndexSet.size());
-	case SumFold:		return aggregate;
-	case MaxFold:		return aggregate;
-	case MinFold:		return aggregate;
+	case AverageFold:	return std::round((qreal) aggregate.sum / aggregate.count);
+	case SumFold:		return aggregate.sum;
+	case MaxFold:		return aggregate.max;
+	case MinFold:		return aggregate.min;
 	default:			assert(false);
 	}
 	return QVariant();
 }
 
+/**
+ * Adds a value to the aggregate, updating count, sum, minimum and maximum at once.
+ * 
+ * @param value	The value to add.
+ */
+void NumericFoldCompositeColumn::Aggregate::add(int value)
+{
+	count++;
+	sum += value;
+	min = std::min(min, value);
+	max = std::max(max, value);
+}
+
 
 
 QStringList NumericFoldCompositeColumn::encodeTypeSpecific() const
@@ -262,19 +422,16 @@ ListStringFoldCompositeColumn::ListStringFoldCompositeColumn(CompositeTable& tab
 
 
 /**
- * Computes the value of the cell at the given row index.
+ * Folds the given target rows into a list string.
  * 
- * Delegates breadcrumb evaluation to FoldCompositeColumn::evaluateBreadcrumbTrail() and string
- * formatting and sorting to formatAndSortIntoStringList().
+ * Delegates string formatting and sorting to formatAndSortIntoStringList().
  * 
- * @param rowIndex	The row index.
- * @return			The computed value of the cell.
+ * @param targetRowIndices	The buffer row indices in the content table to list.
+ * @return					The comma separated list string.
  */
-QVariant ListStringFoldCompositeColumn::computeValueAt(BufferRowIndex rowIndex) const
+QVariant ListStringFoldCompositeColumn::fold(QList<BufferRowIndex> targetRowIndices) const
 {
-	QSet<BufferRowIndex> rowIndexSet = breadcrumbs.evaluate(rowIndex);
-	
-	const QList<QString> stringList = formatAndSortIntoStringList(rowIndexSet);
+	const QList<QString> stringList = formatAndSortIntoStringList(targetRowIndices);
 	return stringList.join(", ");
 }
 
@@ -282,12 +439,12 @@ QVariant ListStringFoldCompositeColumn::computeValueAt(BufferRowIndex rowIndex)
  * As the first step of computing a cell value, formats cells with the given row indices from the
  * content column into a list of strings, then sorts the list alphabetically.
  */
-QStringList ListStringFoldCompositeColumn::formatAndSortIntoStringList(QSet<BufferRowIndex>& rowIndexSet) const
+QStringList ListStringFoldCompositeColumn::formatAndSortIntoStringList(QList<BufferRowIndex> rowIndices) const
 {
 	QStringList stringList = QStringList();
 	
 	// Fetch and format to string
-	for (const BufferRowIndex& rowIndex : rowIndexSet) {
+	for (const BufferRowIndex& rowIndex : std::as_const(rowIndices)) {
 		QVariant content;
 		if (Q_UNLIKELY(contentColumn->primaryKey)) {
 			content = contentTable->getIdentityRepresentationAt(rowIndex);
@@ -307,7 +464,7 @@ QStringList ListStringFoldCompositeColumn::formatAndSortIntoStringList(QSet<Buff
 	
 	// Sort list of strings
 	auto comparator = [] (const QString& string1, const QString& string2) {
-		return QString::localeAwareCompare(string1, string2) < 0;
+		return compareStrings(string1, string2) < 0;
 	};
 	std::stable_sort(stringList.begin(), stringList.end(), comparator);
 	
@@ -356,29 +513,12 @@ HikerListFoldCompositeColumn::HikerListFoldCompositeColumn(CompositeTable& table
 
 
 
-/**
- * Computes the value of the cell at the given row index.
- * 
- * Delegates breadcrumb evaluation to FoldCompositeColumn::evaluateBreadcrumbTrail() and string
- * formatting and sorting to formatAndSortIntoStringList().
- * 
- * @param rowIndex	The row index.
- * @return			The computed value of the cell.
- */
-QVariant HikerListFoldCompositeColumn::computeValueAt(BufferRowIndex rowIndex) const
-{
-	QSet<BufferRowIndex> rowIndexSet = breadcrumbs.evaluate(rowIndex);
-	
-	const QList<QString> stringList = formatAndSortIntoStringList(rowIndexSet);
-	return stringList.join(", ");
-}
-
 /**
  * As the first step of computing a hiker list string, formats cells with the given row indices
  * from the content column into a list of strings, then sorts the list while keeping the default
  * hiker, if present, at the top of the list.
  */
-QStringList HikerListFoldCompositeColumn::formatAndSortIntoStringList(QSet<BufferRowIndex>& rowIndexSet) const
+QStringList HikerListFoldCompositeColumn::formatAndSortIntoStringList(QList<BufferRowIndex> rowIndices) const
 {
 	QStringList stringList = QStringList();
 	
@@ -390,16 +530,16 @@ QStringList HikerListFoldCompositeColumn::formatAndSortIntoStringList(QSet<Buffe
 	if (defaultHiker.present()) {
 		ValidItemID defaultHikerID = VALID_ITEM_ID(defaultHiker.get());
 		BufferRowIndex defaultHikerRowIndex = hikersTable.getBufferIndexForPrimaryKey(defaultHikerID);
-		if (rowIndexSet.contains(defaultHikerRowIndex)) {
+		if (rowIndices.contains(defaultHikerRowIndex)) {
 			QVariant content = contentColumn->getValueAt(defaultHikerRowIndex);
 			assert(content.canConvert<QString>());
 			defaultHikerString = content.toString();
-			// Remove default hiker from row index set
-			rowIndexSet.remove(defaultHikerRowIndex);
+			// Remove default hiker from row index list
+			rowIndices.removeOne(defaultHikerRowIndex);
 		}
 	}
 	
-	for (const BufferRowIndex& rowIndex : rowIndexSet) {
+	for (const BufferRowIndex& rowIndex : std::as_const(rowIndices)) {
 		QVariant content = contentColumn->getValueAt(rowIndex);
 		assert(content.canConvert<QString>());
 		stringList.append(content.toString());
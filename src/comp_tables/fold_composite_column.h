@@ -28,6 +28,8 @@
 #include "numeric_fold_op.h"
 #include "src/db/breadcrumbs.h"
 
+#include <climits>
+
 
 
 /**
@@ -53,10 +55,26 @@ protected:
 	
 public:
 	virtual QSet<ValidItemID> computeIDsAt(BufferRowIndex rowIndex) const override;
+	virtual const NormalTable& getIDTable() const override;
+	virtual BreadcrumbMapping mapRowsToIDTable(const QList<BufferRowIndex>& rowIndices) const override;
+	virtual QVariant computeValueAt(BufferRowIndex rowIndex) const override;
+	virtual QList<QVariant> computeWholeColumn() const override;
+	virtual bool isComputedAsWholeColumn() const override;
 	
 	virtual const QSet<const Column*> getAllUnderlyingColumns() const override;
+	virtual const Breadcrumbs* getBreadcrumbs() const override;
 	
 protected:
+	BreadcrumbMapping evaluateForAllBaseRows() const;
+	
+	/**
+	 * Folds the given rows of the target table into a single cell value.
+	 * 
+	 * @param targetRowIndices	The buffer row indices in the target table, without duplicates, in no particular order.
+	 * @return					The folded cell value.
+	 */
+	virtual QVariant fold(QList<BufferRowIndex> targetRowIndices) const = 0;
+	
 	virtual QStringList encodeTypeSpecific() const override = 0;
 };
 
@@ -71,9 +89,11 @@ class CountFoldCompositeColumn : public FoldCompositeColumn {
 public:
 	CountFoldCompositeColumn(CompositeTable& table, QString name, QString uiName, QString suffix, const NormalTable& countTable);
 	
-	virtual QVariant computeValueAt(BufferRowIndex rowIndex) const override;
+	virtual QList<QVariant> computeWholeColumn() const override;
 	
 protected:
+	virtual QVariant fold(QList<BufferRowIndex> targetRowIndices) const override;
+	
 	virtual QStringList encodeTypeSpecific() const override;
 public:
 	static CountFoldCompositeColumn* decodeTypeSpecific(CompositeTable& parentTable, const QString& name, const QString& uiName, QString& restOfEncoding, Database& db);
@@ -91,13 +111,27 @@ class NumericFoldCompositeColumn : public FoldCompositeColumn {
 	/** The operation to perform when folding values. */
 	const NumericFoldOp op;
 	
+	/** Running count, sum, minimum and maximum of a group of folded values. */
+	struct Aggregate {
+		int count	= 0;
+		int sum		= 0;
+		int min		= INT_MAX;
+		int max		= INT_MIN;
+		
+		void add(int value);
+	};
+	
 public:
 	NumericFoldCompositeColumn(CompositeTable& table, QString name, QString uiName, QString suffix, NumericFoldOp op, const ValueColumn& contentColumn);
 	
-	virtual QVariant computeValueAt(BufferRowIndex rowIndex) const override;
+	virtual QList<QVariant> computeWholeColumn() const override;
 	
 protected:
+	virtual QVariant fold(QList<BufferRowIndex> targetRowIndices) const override;
+	
 	virtual QStringList encodeTypeSpecific() const override;
+private:
+	QVariant getResultFor(const Aggregate& aggregate) const;
 public:
 	static NumericFoldCompositeColumn* decodeTypeSpecific(CompositeTable& parentTable, const QString& name, const QString& uiName, QString& restOfEncoding, Database& db);
 };
@@ -111,10 +145,11 @@ class ListStringFoldCompositeColumn : public FoldCompositeColumn {
 public:
 	ListStringFoldCompositeColumn(CompositeTable& table, QString name, QString uiName, const ValueColumn& contentColumn, const QStringList* enumNames = nullptr, bool isHikerList = false);
 	
-	virtual QVariant computeValueAt(BufferRowIndex rowIndex) const override;
-	virtual QStringList formatAndSortIntoStringList(QSet<BufferRowIndex>& rowIndexSet) const;
+	virtual QStringList formatAndSortIntoStringList(QList<BufferRowIndex> rowIndices) const;
 	
 protected:
+	virtual QVariant fold(QList<BufferRowIndex> targetRowIndices) const override;
+	
 	virtual QStringList encodeTypeSpecific() const override;
 public:
 	static ListStringFoldCompositeColumn* decodeTypeSpecific(CompositeTable& parentTable, const QString& name, const QString& uiName, QString& restOfEncoding, Database& db);
@@ -133,8 +168,7 @@ class HikerListFoldCompositeColumn : public ListStringFoldCompositeColumn {
 public:
 	HikerListFoldCompositeColumn(CompositeTable& table, QString name, QString uiName, const ValueColumn& contentColumn);
 	
-	virtual QVariant computeValueAt(BufferRowIndex rowIndex) const override;
-	virtual QStringList formatAndSortIntoStringList(QSet<BufferRowIndex>& rowIndexSet) const override;
+	virtual QStringList formatAndSortIntoStringList(QList<BufferRowIndex> rowIndices) const override;
 };
 
 
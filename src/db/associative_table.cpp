@@ -41,7 +41,9 @@
 AssociativeTable::AssociativeTable(Database& db, QString name, QString uiName, PrimaryKeyColumn& foreignKeyColumn1, PrimaryKeyColumn& foreignKeyColumn2) :
 	Table(db, name, uiName, true),
 	column1(PrimaryForeignKeyColumn(*this, foreignKeyColumn1.name, foreignKeyColumn1.uiName, foreignKeyColumn1)),
-	column2(PrimaryForeignKeyColumn(*this, foreignKeyColumn2.name, foreignKeyColumn2.uiName, foreignKeyColumn2))
+	column2(PrimaryForeignKeyColumn(*this, foreignKeyColumn2.name, foreignKeyColumn2.uiName, foreignKeyColumn2)),
+	column1Adjacency(QHash<ValidItemID, QList<ValidItemID>>()),
+	column2Adjacency(QHash<ValidItemID, QList<ValidItemID>>())
 {
 	assert(foreignKeyColumn1.primaryKey && foreignKeyColumn1.type == DataType::ID);
 	assert(foreignKeyColumn2.primaryKey && foreignKeyColumn2.type == DataType::ID);
@@ -145,15 +147,13 @@ const NormalTable& AssociativeTable::traverseAssociativeRelation(const PrimaryKe
 int AssociativeTable::getNumberOfMatchingOtherPrimaryKeys(const PrimaryForeignKeyColumn& column, const QSet<ValidItemID>& primaryKeys) const
 {
 	assert(&column == &column1 || &column == &column2);
-	const PrimaryForeignKeyColumn& otherColumn = getOtherColumn(column);
+	const QHash<ValidItemID, QList<ValidItemID>>& adjacency = getAdjacencyFor(column);
 	
 	QSet<ValidItemID> otherSideKeys = QSet<ValidItemID>();
-	for (const QList<QVariant>* const bufferRow : buffer) {
-		for (const ValidItemID& primaryKey : primaryKeys) {
-			if (Q_UNLIKELY(bufferRow->at(column.getIndex()) == ID_GET(primaryKey))) {
-				otherSideKeys.insert(VALID_ITEM_ID(bufferRow->at(otherColumn.getIndex())));
-				break;
-			}
+	for (const ValidItemID& primaryKey : primaryKeys) {
+		const QList<ValidItemID> associatedKeys = adjacency.value(primaryKey);
+		for (const ValidItemID& associatedKey : associatedKeys) {
+			otherSideKeys.insert(associatedKey);
 		}
 	}
 	return otherSideKeys.size();
@@ -171,16 +171,26 @@ int AssociativeTable::getNumberOfMatchingOtherPrimaryKeys(const PrimaryForeignKe
  * @return				The set of all primary keys in the other column which are associated with the given key.
  */
 QSet<ValidItemID> AssociativeTable::getMatchingEntries(const PrimaryForeignKeyColumn& column, ValidItemID primaryKey) const
+{
+	const QList<ValidItemID> associatedKeys = getAssociatedKeys(column, primaryKey);
+	return QSet<ValidItemID>(associatedKeys.constBegin(), associatedKeys.constEnd());
+}
+
+/**
+ * Given a primary key and a column, returns the list of all primary keys in the other column
+ * which are associated with it.
+ * 
+ * Uses the adjacency lists, so the lookup takes time proportional to the number of associated
+ * keys.
+ * 
+ * @param column		The column to search in.
+ * @param primaryKey	The primary key to search for.
+ * @return				The list of all primary keys in the other column which are associated with the given key.
+ */
+const QList<ValidItemID> AssociativeTable::getAssociatedKeys(const PrimaryForeignKeyColumn& column, ValidItemID primaryKey) const
 {
 	assert(&column == &column1 || &column == &column2);
-	const PrimaryForeignKeyColumn& otherColumn = getOtherColumn(column);
-	QSet<ValidItemID> filtered = QSet<ValidItemID>();
-	for (const QList<QVariant>* const bufferRow : buffer) {
-		if (Q_UNLIKELY(bufferRow->at(column.getIndex()) == ID_GET(primaryKey))) {
-			filtered.insert(VALID_ITEM_ID(bufferRow->at(otherColumn.getIndex())));
-		}
-	}
-	return filtered;
+	return getAdjacencyFor(column).value(primaryKey);
 }
 
 
@@ -244,6 +254,73 @@ void AssociativeTable::removeMatchingRows(QWidget& parent, const Column& column,
 
 
 
+// ADDITIONAL BUFFER INDICES
+
+/**
+ * Discards and recreates the adjacency lists for both columns from the current buffer contents.
+ */
+void AssociativeTable::rebuildAdditionalIndices()
+{
+	column1Adjacency.clear();
+	column2Adjacency.clear();
+	
+	for (BufferRowIndex rowIndex = BufferRowIndex(0); rowIndex.isValid(buffer.numRows()); rowIndex++) {
+		addRowToAdditionalIndices(rowIndex);
+	}
+}
+
+/**
+ * Adds the association stored in the given buffer row to the adjacency lists for both columns.
+ * 
+ * @param bufferRowIndex	The index of the new row in the buffer.
+ */
+void AssociativeTable::addRowToAdditionalIndices(BufferRowIndex bufferRowIndex)
+{
+	const ValidItemID key1 = VALID_ITEM_ID(buffer.getCell(bufferRowIndex, column1.getIndex()));
+	const ValidItemID key2 = VALID_ITEM_ID(buffer.getCell(bufferRowIndex, column2.getIndex()));
+	
+	column1Adjacency[key1].append(key2);
+	column2Adjacency[key2].append(key1);
+}
+
+/**
+ * Removes the association stored in the given buffer row from the adjacency lists for both
+ * columns.
+ * 
+ * @param bufferRowIndex	The index of the row which is about to be removed from the buffer.
+ */
+void AssociativeTable::removeRowFromAdditionalIndices(BufferRowIndex bufferRowIndex)
+{
+	const ValidItemID key1 = VALID_ITEM_ID(buffer.getCell(bufferRowIndex, column1.getIndex()));
+	const ValidItemID key2 = VALID_ITEM_ID(buffer.getCell(bufferRowIndex, column2.getIndex()));
+	
+	QList<ValidItemID>& keys2ForKey1 = column1Adjacency[key1];
+	keys2ForKey1.removeOne(key2);
+	if (keys2ForKey1.isEmpty()) column1Adjacency.remove(key1);
+	
+	QList<ValidItemID>& keys1ForKey2 = column2Adjacency[key2];
+	keys1ForKey2.removeOne(key1);
+	if (keys1ForKey2.isEmpty()) column2Adjacency.remove(key2);
+}
+
+/**
+ * Returns the adjacency lists for the given column.
+ * 
+ * @pre The given column is one of the two columns of the table.
+ * 
+ * @param column	A column of the table.
+ * @return			The adjacency lists mapping keys from the given column to associated keys from the other column.
+ */
+const QHash<ValidItemID, QList<ValidItemID>>& AssociativeTable::getAdjacencyFor(const PrimaryForeignKeyColumn& column) const
+{
+	if (&column == &column1) return column1Adjacency;
+	if (&column == &column2) return column2Adjacency;
+	assert(false);
+	return column1Adjacency;
+}
+
+
+
 // QABSTRACTIMTEMMODEL IMPLEMENTATION
 
 /**
@@ -41,6 +41,11 @@ class AssociativeTable : public Table {
 	/** The second primary and foreign key column of the table. */
 	PrimaryForeignKeyColumn column2;
 	
+	/** For every key in the first column, the list of keys in the second column associated with it. */
+	QHash<ValidItemID, QList<ValidItemID>> column1Adjacency;
+	/** For every key in the second column, the list of keys in the first column associated with it. */
+	QHash<ValidItemID, QList<ValidItemID>> column2Adjacency;
+	
 public:
 	AssociativeTable(Database& db, QString name, QString uiName, PrimaryKeyColumn& foreignKeyColumn1, PrimaryKeyColumn& foreignKeyColumn2);
 	virtual ~AssociativeTable();
@@ -55,6 +60,7 @@ public:
 	// Buffer access
 	int getNumberOfMatchingOtherPrimaryKeys(const PrimaryForeignKeyColumn& column, const QSet<ValidItemID>& primaryKeys) const;
 	QSet<ValidItemID> getMatchingEntries(const PrimaryForeignKeyColumn& column, ValidItemID primaryKey) const;
+	const QList<ValidItemID> getAssociatedKeys(const PrimaryForeignKeyColumn& column, ValidItemID primaryKey) const;
 	
 	// Modifications (passthrough)
 	void addRow(QWidget& parent, const QList<ColumnDataPair>& columnDataPairs);
@@ -62,6 +68,15 @@ public:
 	void removeMatchingRows(QWidget& parent, const Column& column, ValidItemID primaryKey);
 	void removeMatchingRows(QWidget& parent, const Column& column, const QSet<ValidItemID>& primaryKeys);
 	
+protected:
+	// Additional buffer indices
+	void rebuildAdditionalIndices() override;
+	void addRowToAdditionalIndices(BufferRowIndex bufferRowIndex) override;
+	void removeRowFromAdditionalIndices(BufferRowIndex bufferRowIndex) override;
+private:
+	const QHash<ValidItemID, QList<ValidItemID>>& getAdjacencyFor(const PrimaryForeignKeyColumn& column) const;
+	
+public:
 	// QAbstractItemModel implementation (completes implementation in Table)
 	void multiData(const QModelIndex& index, QModelRoleDataSpan roleDataSpan) const override;
 };
@@ -28,6 +28,83 @@
 
 
 
+/**
+ * Creates a new BreadcrumbMapping from the given offset and target lists.
+ * 
+ * @param offsets	For each start row, the position of its first target row in targets, followed by the total number of target rows.
+ * @param targets	The target rows for all start rows, grouped by start row.
+ */
+BreadcrumbMapping::BreadcrumbMapping(const QList<int>& offsets, const QList<BufferRowIndex>& targets) :
+	offsets(offsets),
+	targets(targets)
+{
+	assert(!offsets.isEmpty());
+	assert(offsets.first() == 0);
+	assert(offsets.last() == targets.size());
+}
+
+
+/**
+ * Returns the number of start rows the mapping was created for.
+ * 
+ * @return	The number of start rows.
+ */
+int BreadcrumbMapping::numStartRows() const
+{
+	return offsets.size() - 1;
+}
+
+/**
+ * Returns the number of target rows for the start row at the given position.
+ * 
+ * @param startPosition	The position of the start row in the list of start rows the mapping was created for.
+ * @return				The number of target rows reached from that start row.
+ */
+int BreadcrumbMapping::numTargetRowsFor(int startPosition) const
+{
+	assert(startPosition >= 0 && startPosition < numStartRows());
+	return offsets.at(startPosition + 1) - offsets.at(startPosition);
+}
+
+/**
+ * Returns the target rows for the start row at the given position.
+ * 
+ * @param startPosition	The position of the start row in the list of start rows the mapping was created for.
+ * @return				The target rows reached from that start row.
+ */
+QList<BufferRowIndex> BreadcrumbMapping::getTargetRowsFor(int startPosition) const
+{
+	return QList<BufferRowIndex>(targetRowsBegin(startPosition), targetRowsEnd(startPosition));
+}
+
+/**
+ * Returns an iterator to the first target row for the start row at the given position.
+ * 
+ * @param startPosition	The position of the start row in the list of start rows the mapping was created for.
+ * @return				An iterator to the first target row reached from that start row.
+ */
+QList<BufferRowIndex>::const_iterator BreadcrumbMapping::targetRowsBegin(int startPosition) const
+{
+	assert(startPosition >= 0 && startPosition < numStartRows());
+	return targets.constBegin() + offsets.at(startPosition);
+}
+
+/**
+ * Returns an iterator past the last target row for the start row at the given position.
+ * 
+ * @param startPosition	The position of the start row in the list of start rows the mapping was created for.
+ * @return				An iterator past the last target row reached from that start row.
+ */
+QList<BufferRowIndex>::const_iterator BreadcrumbMapping::targetRowsEnd(int startPosition) const
+{
+	assert(startPosition >= 0 && startPosition < numStartRows());
+	return targets.constBegin() + offsets.at(startPosition + 1);
+}
+
+
+
+
+
 /**
  * Creates a Breadcrumb from two columns.
  * 
@@ -131,7 +208,8 @@ bool Breadcrumb::operator!=(const Breadcrumb& other) const
  * Creates a new empty Breadcrumbs list.
  */
 Breadcrumbs::Breadcrumbs() :
-	list(QList<Breadcrumb>())
+	list(QList<Breadcrumb>()),
+	joinPlan(QList<JoinStep>())
 {}
 
 /**
@@ -140,7 +218,8 @@ Breadcrumbs::Breadcrumbs() :
  * @param breadcrumbs	The list to create the Breadcrumbs from.
  */
 Breadcrumbs::Breadcrumbs(const QList<Breadcrumb>& breadcrumbs) :
-	list(breadcrumbs)
+	list(breadcrumbs),
+	joinPlan(QList<JoinStep>())
 {
 	if (!list.isEmpty()) {
 		assert(!list.first().firstColumn.table.isAssociative);
@@ -156,6 +235,8 @@ Breadcrumbs::Breadcrumbs(const QList<Breadcrumb>& breadcrumbs) :
 			currentTable = &secondColumn.table;
 		}
 	}
+	
+	compileJoinPlan();
 }
 
 /**
@@ -260,6 +341,49 @@ bool Breadcrumbs::goesVia(const Table& table) const
 	return false;
 }
 
+/**
+ * Indicates whether any breadcrumb in the trail leads into the given table.
+ * 
+ * @param table	The table to check for.
+ * @return		True if the second column of any crumb in the trail belongs to the given table, false otherwise.
+ */
+bool Breadcrumbs::reaches(const Table& table) const
+{
+	for (const Breadcrumb& crumb : list) {
+		if (&crumb.secondColumn.table == &table) return true;
+	}
+	return false;
+}
+
+/**
+ * Returns the part of the breadcrumb trail which leads from the start table to the given table,
+ * reversed so that it leads from the given table back to the start table.
+ * 
+ * Evaluating the returned trail for a row in the given table yields all rows in the start table
+ * whose own evaluation passes through that row.
+ * 
+ * @pre The trail reaches the given table.
+ * 
+ * @param table	The table up to which to reverse the trail.
+ * @return		The reversed trail from the given table back to the start table.
+ */
+Breadcrumbs Breadcrumbs::getReversedUpTo(const NormalTable& table) const
+{
+	assert(reaches(table));
+	
+	int endIndex = 0;
+	while (&list.at(endIndex).secondColumn.table != &table) {
+		endIndex++;
+	}
+	
+	QList<Breadcrumb> reversedList = QList<Breadcrumb>();
+	for (int i = endIndex; i >= 0; i--) {
+		const Breadcrumb& crumb = list.at(i);
+		reversedList.append(Breadcrumb(crumb.secondColumn, crumb.firstColumn));
+	}
+	return Breadcrumbs(reversedList);
+}
+
 
 /**
  * Indicates whether the list of breadcrumbs is equal to another list of breadcrumbs.
@@ -302,6 +426,7 @@ void Breadcrumbs::append(const Breadcrumb& breadcrumb)
 	}
 	
 	list.append(breadcrumb);
+	compileJoinPlan();
 }
 
 
@@ -487,3 +612,113 @@ QList<BufferRowIndex> Breadcrumbs::evaluateForStats(const QSet<BufferRowIndex>&
 	
 	return currentRowIndexList;
 }
+
+
+
+/**
+ * Evaluates the breadcrumb trail for a whole list of start rows at once.
+ * 
+ * Instead of following the trail separately for every start row, each breadcrumb is applied to
+ * the intermediate results of all start rows in one pass, using the compiled join plan. The
+ * intermediate and final results are kept in a BreadcrumbMapping, which stores the rows reached
+ * from every start row in one contiguous list.
+ * 
+ * Without duplicates, the target rows for each start row are the same as those returned by
+ * evaluate(). With duplicates, they are the same as those returned by evaluateForStats() for that
+ * single start row. In both cases, the order of the target rows is unspecified.
+ * 
+ * @param startBufferRowIndices	The row indices in the start table to evaluate the trail for.
+ * @param keepDuplicates		Whether to keep rows which are reached multiple times from the same start row.
+ * @return						The mapping from the position of each start row to its target rows.
+ */
+BreadcrumbMapping Breadcrumbs::evaluateForRows(const QList<BufferRowIndex>& startBufferRowIndices, bool keepDuplicates) const
+{
+	const int numStartRows = startBufferRowIndices.size();
+	
+	QList<int> currentOffsets = QList<int>();
+	currentOffsets.reserve(numStartRows + 1);
+	for (int i = 0; i <= numStartRows; i++) {
+		currentOffsets.append(i);
+	}
+	QList<BufferRowIndex> currentRows = startBufferRowIndices;
+	
+	for (const JoinStep& step : joinPlan) {
+		QList<int> nextOffsets = QList<int>();
+		nextOffsets.reserve(numStartRows + 1);
+		QList<BufferRowIndex> nextRows = QList<BufferRowIndex>();
+		nextRows.reserve(currentRows.size());
+		
+		// For deduplication, remember for each target row which start row reached it last
+		QList<int> lastSeenFromStart = QList<int>();
+		if (!keepDuplicates) {
+			lastSeenFromStart = QList<int>(step.targetTable->getNumberOfRows(), -1);
+		}
+		
+		nextOffsets.append(0);
+		for (int startPosition = 0; startPosition < numStartRows; startPosition++) {
+			const int segmentEnd = currentOffsets.at(startPosition + 1);
+			for (int i = currentOffsets.at(startPosition); i < segmentEnd; i++) {
+				// Look up key stored in source column at current row index
+				const ItemID key = ItemID(step.sourceTable->getBufferCell(currentRows.at(i), step.sourceColumnIndex));
+				if (key.isInvalid()) continue;
+				
+				if (step.forward) {
+					// Forward reference (lookup, result is single row)
+					const BufferRowIndex targetRow = step.targetTable->getBufferIndexForPrimaryKey(FORCE_VALID(key));
+					if (Q_UNLIKELY(targetRow.isInvalid())) continue;
+					if (!keepDuplicates) {
+						int& lastSeen = lastSeenFromStart[targetRow.get()];
+						if (lastSeen == startPosition) continue;
+						lastSeen = startPosition;
+					}
+					nextRows.append(targetRow);
+				}
+				else {
+					// Backward reference (reference search, result is list of rows)
+					const QList<BufferRowIndex> matchingRows = step.targetTable->getMatchingBufferRowIndices(*step.targetColumn, key.asQVariant());
+					for (const BufferRowIndex& targetRow : matchingRows) {
+						if (!keepDuplicates) {
+							int& lastSeen = lastSeenFromStart[targetRow.get()];
+							if (lastSeen == startPosition) continue;
+							lastSeen = startPosition;
+						}
+						nextRows.append(targetRow);
+					}
+				}
+			}
+			nextOffsets.append(nextRows.size());
+		}
+		
+		currentOffsets = nextOffsets;
+		currentRows = nextRows;
+	}
+	
+	return BreadcrumbMapping(currentOffsets, currentRows);
+}
+
+
+
+/**
+ * Compiles the list of breadcrumbs into a join plan, resolving the tables and column positions
+ * involved in each step ahead of time.
+ * 
+ * Needs to be called whenever the list of breadcrumbs changes.
+ */
+void Breadcrumbs::compileJoinPlan()
+{
+	joinPlan.clear();
+	joinPlan.reserve(list.size());
+	for (const Breadcrumb& crumb : list) {
+		const Table& sourceTable = crumb.firstColumn.table;
+		const Table& targetTable = crumb.secondColumn.table;
+		assert(!crumb.isForward() || !targetTable.isAssociative);
+		
+		joinPlan.append({
+			&sourceTable,
+			crumb.firstColumn.getIndex(),
+			&targetTable,
+			&crumb.secondColumn,
+			crumb.isForward()
+		});
+	}
+}
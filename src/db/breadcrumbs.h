@@ -52,6 +52,36 @@ public:
 	
 	bool operator==(const Breadcrumb& other) const;
 	bool operator!=(const Breadcrumb& other) const;
+	
+	friend class Breadcrumbs;
+};
+
+
+
+/**
+ * A class holding the result of evaluating a breadcrumb trail for many start rows at once.
+ * 
+ * The target rows for all start rows are stored in a single list, ordered by start row
+ * (compressed sparse row format). For each start row, an offset into that list marks where its
+ * target rows begin.
+ * 
+ * @see Breadcrumbs::evaluateForRows()
+ */
+class BreadcrumbMapping
+{
+	/** For each start row, the position of its first target row in targets, plus one final entry marking the end. */
+	QList<int> offsets;
+	/** The target rows for all start rows, grouped by start row. */
+	QList<BufferRowIndex> targets;
+	
+public:
+	BreadcrumbMapping(const QList<int>& offsets, const QList<BufferRowIndex>& targets);
+	
+	int numStartRows() const;
+	int numTargetRowsFor(int startPosition) const;
+	QList<BufferRowIndex> getTargetRowsFor(int startPosition) const;
+	QList<BufferRowIndex>::const_iterator targetRowsBegin(int startPosition) const;
+	QList<BufferRowIndex>::const_iterator targetRowsEnd(int startPosition) const;
 };
 
 
@@ -64,7 +94,26 @@ public:
  */
 class Breadcrumbs
 {
+	/**
+	 * A single breadcrumb, compiled into a form which can be evaluated without further lookups
+	 * of tables and column positions.
+	 */
+	struct JoinStep {
+		/** The table in which the step starts. */
+		const Table* sourceTable;
+		/** The index of the column in the source table which holds the keys to follow. */
+		int sourceColumnIndex;
+		/** The table in which the step ends. */
+		const Table* targetTable;
+		/** The column in the target table in which to look up the keys. */
+		const Column* targetColumn;
+		/** Whether the step is a forward reference (primary key lookup) rather than a backward reference (reference search). */
+		bool forward;
+	};
+	
 	QList<Breadcrumb> list;
+	/** The compiled form of the breadcrumb trail. */
+	QList<JoinStep> joinPlan;
 	
 public:
 	Breadcrumbs();
@@ -78,6 +127,8 @@ public:
 	int length() const;
 	bool isForwardOnly() const;
 	bool goesVia(const Table& table) const;
+	bool reaches(const Table& table) const;
+	Breadcrumbs getReversedUpTo(const NormalTable& table) const;
 	
 	bool operator==(const Breadcrumbs& other) const;
 	bool operator!=(const Breadcrumbs& other) const;
@@ -89,6 +140,10 @@ public:
 	QSet<BufferRowIndex> evaluate(BufferRowIndex initialBufferRowIndex) const;
 	BufferRowIndex evaluateAsForwardChain(BufferRowIndex initialBufferRowIndex) const;
 	QList<BufferRowIndex> evaluateForStats(const QSet<BufferRowIndex>& initialBufferRowIndices) const;
+	BreadcrumbMapping evaluateForRows(const QList<BufferRowIndex>& startBufferRowIndices, bool keepDuplicates) const;
+	
+private:
+	void compileJoinPlan();
 };
 
 
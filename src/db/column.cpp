@@ -29,6 +29,9 @@
 
 #include <QCoreApplication>
 
+#include <limits>
+#include <numeric>
+
 using std::shared_ptr;
 
 
@@ -135,7 +138,7 @@ int Column::getIndex() const
  */
 QVariant Column::getValueAt(BufferRowIndex bufferRowIndex) const
 {
-	return table.getBufferRow(bufferRowIndex)->at(getIndex());
+	return table.getBufferCell(bufferRowIndex, getIndex());
 }
 
 /**
@@ -149,7 +152,7 @@ QVariant Column::getValueAt(BufferRowIndex bufferRowIndex) const
 QVariant Column::getValueFor(ValidItemID itemID) const
 {
 	assert(!table.isAssociative);
-	return getValueAt(((NormalTable&) table).getBufferIndexForPrimaryKey(itemID));
+	return getValueAt(table.getBufferIndexForPrimaryKey(itemID));
 }
 
 /**
@@ -269,6 +272,53 @@ PrimaryForeignKeyColumn::PrimaryForeignKeyColumn(const Table& table, QString nam
 
 
 
+/**
+ * Returns the collator used for ordering all string cells, so that strings are compared the same
+ * way whether they are compared directly or ranked by sort keys.
+ * 
+ * Each thread uses its own collator, since cells are also compared on worker threads.
+ * 
+ * @return	The collator for string cells.
+ */
+const QCollator& getCellCollator()
+{
+	thread_local const QCollator collator = QCollator();
+	return collator;
+}
+
+/**
+ * Compares two strings using the collator for string cells (see getCellCollator()).
+ * 
+ * @param string1	The first string.
+ * @param string2	The second string.
+ * @return			A negative value if the first string is ordered first, a positive value if the second one is, or 0 if they are equal.
+ */
+int compareStrings(const QString& string1, const QString& string2)
+{
+	return getCellCollator().compare(string1, string2);
+}
+
+/**
+ * Determines whether a cell of the given type is empty for the purpose of comparing and sorting.
+ * 
+ * Besides invalid values, this includes invalid dates and times, since QVariants holding those
+ * are valid themselves.
+ * 
+ * @param type	The type of the cell.
+ * @param value	The cell's value.
+ * @return		True if the cell is empty, false otherwise.
+ */
+bool isEmptyCell(DataType type, const QVariant& value)
+{
+	if (!value.isValid() || value.isNull()) return true;
+	
+	switch (type) {
+	case Date:	return !value.toDate().isValid();
+	case Time:	return !value.toTime().isValid();
+	default:	return false;
+	}
+}
+
 /**
  * Compares two cells of the given type.
  * 
@@ -280,8 +330,8 @@ PrimaryForeignKeyColumn::PrimaryForeignKeyColumn(const Table& table, QString nam
 bool compareCells(DataType type, const QVariant& value1, const QVariant& value2)
 {
 	// return result of operation 'value1 < value2'
-	const bool value1Valid = value1.isValid();
-	const bool value2Valid = value2.isValid();
+	const bool value1Valid = !isEmptyCell(type, value1);
+	const bool value2Valid = !isEmptyCell(type, value2);
 	
 	if (!value1Valid && !value2Valid)	return false;
 	if (!value1Valid &&  value2Valid)	return true;
@@ -312,7 +362,7 @@ bool compareCells(DataType type, const QVariant& value1, const QVariant& value2)
 		assert(value1.canConvert<bool>() && value2.canConvert<bool>());
 		return value1.toBool() < value2.toBool();
 	case String:
-		return QString::localeAwareCompare(value1.toString(), value2.toString()) < 0;
+		return compareStrings(value1.toString(), value2.toString()) < 0;
 	case Date:
 		assert(value1.canConvert<QDate>() && value2.canConvert<QDate>());
 		return value1.toDate() < value2.toDate();
@@ -325,6 +375,109 @@ bool compareCells(DataType type, const QVariant& value1, const QVariant& value2)
 	}
 }
 
+/**
+ * Converts a non-empty cell of the given type to an integer which compares like the cell itself.
+ * 
+ * Not applicable to strings, which have to be compared using collation (see computeSortKeys()).
+ * 
+ * @param type	The type of the cell. Must not be String.
+ * @param value	The cell's value. Must not be empty (see isEmptyCell()).
+ * @return		An integer which compares to those of other cells of the same type like the cell.
+ */
+qint64 getNumericSortKey(DataType type, const QVariant& value)
+{
+	assert(!isEmptyCell(type, value));
+	
+	switch (type) {
+	case Integer:
+	case ID:
+	case Enum:
+		return value.toInt();
+	case DualEnum: {
+		assert(value.canConvert<QList<QVariant>>());
+		const QList<QVariant> intList = value.toList();
+		assert(intList.size() == 2);
+		return (qint64) intList.at(0).toInt() * ((qint64) 1 << 32) + intList.at(1).toInt();
+	}
+	case Bit:
+		assert(value.canConvert<bool>());
+		return value.toBool();
+	case Date:
+		assert(value.canConvert<QDate>());
+		return value.toDate().toJulianDay();
+	case Time:
+		assert(value.canConvert<QTime>());
+		return value.toTime().msecsSinceStartOfDay();
+	default:
+		assert(false);
+		return 0;
+	}
+}
+
+/**
+ * Computes a sort key for each of the given cells, so that comparing the keys as integers is
+ * equivalent to comparing the cells using compareCells().
+ * 
+ * Empty cells (see isEmptyCell()) are given the smallest possible key. Strings are ranked by their collation keys,
+ * which are computed only once for every distinct string.
+ * 
+ * @param type		The type of the cells.
+ * @param values	The cells' values.
+ * @return			The sort keys for the given cells, in the same order.
+ */
+QList<qint64> computeSortKeys(DataType type, const QList<QVariant>& values)
+{
+	const qint64 nullKey = std::numeric_limits<qint64>::min();
+	QList<qint64> keys = QList<qint64>();
+	keys.reserve(values.size());
+	
+	if (type != String) {
+		for (const QVariant& value : values) {
+			keys.append(isEmptyCell(type, value) ? nullKey : getNumericSortKey(type, value));
+		}
+		return keys;
+	}
+	
+	// Collect distinct strings and compute their collation keys
+	QHash<QString, int> distinctStringIndices = QHash<QString, int>();
+	QList<QCollatorSortKey> collationKeys = QList<QCollatorSortKey>();
+	const QCollator& collator = getCellCollator();
+	for (const QVariant& value : values) {
+		if (isEmptyCell(type, value)) {
+			keys.append(nullKey);
+			continue;
+		}
+		const QString string = value.toString();
+		auto iter = distinctStringIndices.constFind(string);
+		if (iter == distinctStringIndices.constEnd()) {
+			iter = distinctStringIndices.insert(string, collationKeys.size());
+			collationKeys.append(collator.sortKey(string));
+		}
+		keys.append(iter.value());
+	}
+	
+	// Rank distinct strings, giving equal strings under collation the same rank
+	QList<int> sortedStringIndices = QList<int>(collationKeys.size());
+	std::iota(sortedStringIndices.begin(), sortedStringIndices.end(), 0);
+	std::sort(sortedStringIndices.begin(), sortedStringIndices.end(), [&collationKeys] (int index1, int index2) {
+		return collationKeys.at(index1).compare(collationKeys.at(index2)) < 0;
+	});
+	QList<qint64> ranks = QList<qint64>(collationKeys.size());
+	qint64 rank = 0;
+	for (int i = 0; i < sortedStringIndices.size(); i++) {
+		const int stringIndex = sortedStringIndices.at(i);
+		if (i > 0 && collationKeys.at(sortedStringIndices.at(i - 1)).compare(collationKeys.at(stringIndex)) < 0) {
+			rank++;
+		}
+		ranks[stringIndex] = rank;
+	}
+	
+	for (qint64& key : keys) {
+		if (key != nullKey) key = ranks.at(key);
+	}
+	return keys;
+}
+
 
 
 
@@ -28,6 +28,7 @@
 #include "src/db/row_index.h"
 #include "src/data/item_id.h"
 
+#include <QCollator>
 #include <QSet>
 
 using std::shared_ptr;
@@ -128,7 +129,12 @@ public:
 
 
 
+const QCollator& getCellCollator();
+int compareStrings(const QString& string1, const QString& string2);
+bool isEmptyCell(DataType type, const QVariant& value);
 bool compareCells(DataType type, const QVariant& value1, const QVariant& value2);
+qint64 getNumericSortKey(DataType type, const QVariant& value);
+QList<qint64> computeSortKeys(DataType type, const QList<QVariant>& values);
 
 
 
@@ -23,6 +23,7 @@
 
 #include "database.h"
 
+#include "src/db/db_copy_thread.h"
 #include "src/db/db_error.h"
 #include "src/db/db_upgrade.h"
 #include "src/main/helpers.h"
@@ -44,8 +45,10 @@ Database::Database() :
 	databaseLoaded(false),
 	tables(QList<Table*>()),
 	acceptDataModifications(false),
+	changesTransactionOpen(false),
 	changedColumns(QSet<const Column*>()),
 	rowsAddedOrRemovedPerTable(QHash<const Table*, QList<QPair<BufferRowIndex, bool>>>()),
+	changedRowsPerColumn(QHash<const Column*, QSet<BufferRowIndex>>()),
 	breadcrumbMatrix(QMap<const NormalTable*, QMap<const NormalTable*, Breadcrumbs>>()),
 	tripsTable			(TripsTable			(*this)),
 	hikersTable			(HikersTable		(*this)),
@@ -95,8 +98,10 @@ void Database::reset()
 	
 	for (Table* const table : std::as_const(tables)) {
 		table->resetBuffer();
+		table->clearPreparedQueries();
 	}
 	
+	if (databaseLoaded) optimizeBeforeClosing();
 	QSqlDatabase::database().close();
 	
 	databaseLoaded = false;
@@ -138,6 +143,8 @@ void Database::createNew(QWidget& parent, const QString& filepath)
 	
 	// Set version
 	projectSettings.databaseVersion.set(parent, getAppVersion());
+	
+	applyPerformanceProfile(parent);
 }
 
 /**
@@ -173,17 +180,23 @@ bool Database::openExisting(QWidget& parent, const QString& filepath)
 		reset();
 		return false;
 	}
+	
+	applyPerformanceProfile(parent);
 	return true;
 }
 
 /**
  * Copies the current database file to a new filepath and opens a connection to the new file.
  * 
+ * The copy is created on a worker thread while the connection to the current file stays open, and
+ * can be canceled by the user.
+ * 
  * @param parent	The parent window.
  * @param filepath	The filepath for the new copy of the database file to create and open.
+ * @param canceled	Set to whether the copy was canceled by the user. In that case, no new file remains.
  * @return			True if the save was successful and the new file is now opened, false otherwise.
  */
-bool Database::saveAs(QWidget& parent, const QString& filepath)
+bool Database::saveAs(QWidget& parent, const QString& filepath, bool& canceled)
 {
 	assert(databaseLoaded);
 	qDebug() << "Saving database file as" << filepath;
@@ -191,26 +204,27 @@ bool Database::saveAs(QWidget& parent, const QString& filepath)
 	QString oldFilepath = getCurrentFilepath();
 	assert(!QFile(filepath).exists() && oldFilepath.compare(filepath, Qt:: CaseInsensitive) != 0);
 	
-	QSqlDatabase sql = QSqlDatabase::database();
-	sql.close();
-	
 	// Copy file
-	if (!QFile(oldFilepath).copy(filepath)) {
-		qDebug() << "File copy failed:" << oldFilepath << "to" << filepath;
-		
-		// reopen old connection
-		if (!sql.open())
-			displayError(parent, sql.lastError());
+	QString labelText = tr("Saving project file...");
+	if (!DatabaseCopyThread::copyWithProgressDialog(parent, oldFilepath, filepath, labelText, canceled)) {
+		qDebug() << (canceled ? "File copy was canceled:" : "File copy failed:") << oldFilepath << "to" << filepath;
 		return false;
 	}
 	
-	// Set filename
+	// Switch connection over to the new file
+	for (Table* const table : std::as_const(tables)) {
+		table->clearPreparedQueries();
+	}
+	optimizeBeforeClosing();
+	QSqlDatabase sql = QSqlDatabase::database();
+	sql.close();
 	sql.setDatabaseName(filepath);
 	
 	// Open connection
 	if (!sql.open())
 		displayError(parent, sql.lastError());
 	
+	applyPerformanceProfile(parent);
 	return true;
 }
 
@@ -230,6 +244,78 @@ QString Database::getCurrentFilepath() const
 	return filepath;
 }
 
+/**
+ * Configures the connection to the open database file according to the performance profile in the
+ * project settings.
+ * 
+ * Has to be called whenever a connection is opened, and again after the profile was changed.
+ * Must not be called while data is being changed.
+ * 
+ * @pre A database file is currently open.
+ * 
+ * @param parent	The parent window.
+ */
+void Database::applyPerformanceProfile(QWidget& parent)
+{
+	assert(databaseLoaded);
+	assert(!acceptDataModifications);
+	
+	QStringList pragmas = QStringList();
+	switch (projectSettings.performanceProfile.get()) {
+	case SafePerformanceProfile:
+		pragmas = {
+			"journal_mode = DELETE",
+			"synchronous = FULL",
+			"cache_size = -2000",		// SQLite default, 2 MiB
+			"mmap_size = 0",
+			"temp_store = DEFAULT"
+		};
+		break;
+	case BalancedPerformanceProfile:
+		pragmas = {
+			"journal_mode = WAL",
+			"synchronous = NORMAL",
+			"cache_size = -16000",		// 16 MiB
+			"mmap_size = 67108864",		// 64 MiB
+			"temp_store = MEMORY"
+		};
+		break;
+	case FastPerformanceProfile:
+		pragmas = {
+			"journal_mode = WAL",
+			"synchronous = OFF",
+			"cache_size = -64000",		// 64 MiB
+			"mmap_size = 268435456",	// 256 MiB
+			"temp_store = MEMORY"
+		};
+		break;
+	default:
+		assert(false);
+	}
+	
+	for (const QString& pragma : std::as_const(pragmas)) {
+		QString queryString = "PRAGMA " + pragma;
+		QSqlQuery query = QSqlQuery();
+		query.setForwardOnly(true);
+		if (!query.exec(queryString)) {
+			displayError(parent, query.lastError(), queryString);
+		}
+	}
+}
+
+/**
+ * Lets SQLite update its query planner statistics before the connection is closed.
+ * 
+ * Failure is not critical and only logged.
+ */
+void Database::optimizeBeforeClosing()
+{
+	QSqlQuery query = QSqlQuery();
+	if (!query.exec("PRAGMA optimize")) {
+		qDebug() << "PRAGMA optimize failed:" << query.lastError().text();
+	}
+}
+
 
 /**
  * Populates the buffers of all regular tables (not project settings) by loading the data from the
@@ -404,23 +490,23 @@ unique_ptr<Ascent> Database::getAscentAt(BufferRowIndex rowIndex) const
 {
 	assert(databaseLoaded);
 	
-	const QList<QVariant>* row = ascentsTable.getBufferRow(rowIndex);
-	assert(row->size() == ascentsTable.getNumberOfColumns());
-	
-	ValidItemID ascentID = VALID_ITEM_ID(row->at(ascentsTable.primaryKeyColumn.getIndex()));
-	QString	title				= row->at(ascentsTable.titleColumn				.getIndex()).toString();
-	ItemID	peakID				= row->at(ascentsTable.peakIDColumn				.getIndex());
-	QDate	date				= row->at(ascentsTable.dateColumn				.getIndex()).toDate();
-	int		perDayIndex			= row->at(ascentsTable.peakOnDayColumn			.getIndex()).toInt();
-	QTime	time				= row->at(ascentsTable.timeColumn				.getIndex()).toTime();
-	int		elevationGain		= row->at(ascentsTable.elevationGainColumn		.getIndex()).toInt();
-	int		hikeKind			= row->at(ascentsTable.hikeKindColumn			.getIndex()).toInt();
-	bool	traverse			= row->at(ascentsTable.traverseColumn			.getIndex()).toBool();
-	int		difficultySystem	= row->at(ascentsTable.difficultySystemColumn	.getIndex()).toInt();
-	int		difficultyGrade		= row->at(ascentsTable.difficultyGradeColumn	.getIndex()).toInt();
-	ItemID	tripID				= row->at(ascentsTable.tripIDColumn				.getIndex());
-	QString	gpxFilepath			= row->at(ascentsTable.gpxFileColumn			.getIndex()).toString();
-	QString	description			= row->at(ascentsTable.descriptionColumn		.getIndex()).toString();
+	const QList<QVariant> row = ascentsTable.getBufferRow(rowIndex);
+	assert(row.size() == ascentsTable.getNumberOfColumns());
+	
+	ValidItemID ascentID = VALID_ITEM_ID(row.at(ascentsTable.primaryKeyColumn.getIndex()));
+	QString	title				= row.at(ascentsTable.titleColumn				.getIndex()).toString();
+	ItemID	peakID				= row.at(ascentsTable.peakIDColumn				.getIndex());
+	QDate	date				= row.at(ascentsTable.dateColumn				.getIndex()).toDate();
+	int		perDayIndex			= row.at(ascentsTable.peakOnDayColumn			.getIndex()).toInt();
+	QTime	time				= row.at(ascentsTable.timeColumn				.getIndex()).toTime();
+	int		elevationGain		= row.at(ascentsTable.elevationGainColumn		.getIndex()).toInt();
+	int		hikeKind			= row.at(ascentsTable.hikeKindColumn			.getIndex()).toInt();
+	bool	traverse			= row.at(ascentsTable.traverseColumn			.getIndex()).toBool();
+	int		difficultySystem	= row.at(ascentsTable.difficultySystemColumn	.getIndex()).toInt();
+	int		difficultyGrade		= row.at(ascentsTable.difficultyGradeColumn	.getIndex()).toInt();
+	ItemID	tripID				= row.at(ascentsTable.tripIDColumn				.getIndex());
+	QString	gpxFilepath			= row.at(ascentsTable.gpxFileColumn			.getIndex()).toString();
+	QString	description			= row.at(ascentsTable.descriptionColumn		.getIndex()).toString();
 	
 	QSet<ValidItemID>	hikerIDs	= participatedTable.getMatchingEntries(participatedTable.ascentIDColumn, ascentID);
 	QList<Photo>		photos		= photosTable.getPhotosForAscent(ascentID);
@@ -441,17 +527,17 @@ unique_ptr<Peak> Database::getPeakAt(BufferRowIndex rowIndex) const
 {
 	assert(databaseLoaded);
 	
-	const QList<QVariant>* row = peaksTable.getBufferRow(rowIndex);
-	assert(row->size() == peaksTable.getNumberOfColumns());
+	const QList<QVariant> row = peaksTable.getBufferRow(rowIndex);
+	assert(row.size() == peaksTable.getNumberOfColumns());
 	
-	ValidItemID peakID = VALID_ITEM_ID(row->at(peaksTable.primaryKeyColumn	.getIndex()));
-	QString	name		= row->at(peaksTable.nameColumn			.getIndex()).toString();
-	int		height		= row->at(peaksTable.heightColumn		.getIndex()).toInt();
-	bool	volcano		= row->at(peaksTable.volcanoColumn		.getIndex()).toBool();
-	ItemID	regionID	= row->at(peaksTable.regionIDColumn		.getIndex()).toInt();
-	QString	mapsLink	= row->at(peaksTable.mapsLinkColumn		.getIndex()).toString();
-	QString	earthLink	= row->at(peaksTable.earthLinkColumn	.getIndex()).toString();
-	QString	wikiLink	= row->at(peaksTable.wikiLinkColumn		.getIndex()).toString();
+	ValidItemID peakID = VALID_ITEM_ID(row.at(peaksTable.primaryKeyColumn	.getIndex()));
+	QString	name		= row.at(peaksTable.nameColumn			.getIndex()).toString();
+	int		height		= row.at(peaksTable.heightColumn		.getIndex()).toInt();
+	bool	volcano		= row.at(peaksTable.volcanoColumn		.getIndex()).toBool();
+	ItemID	regionID	= row.at(peaksTable.regionIDColumn		.getIndex()).toInt();
+	QString	mapsLink	= row.at(peaksTable.mapsLinkColumn		.getIndex()).toString();
+	QString	earthLink	= row.at(peaksTable.earthLinkColumn	.getIndex()).toString();
+	QString	wikiLink	= row.at(peaksTable.wikiLinkColumn		.getIndex()).toString();
 	
 	return make_unique<Peak>(peakID, name, height, volcano, regionID, mapsLink, earthLink, wikiLink);
 }
@@ -469,14 +555,14 @@ unique_ptr<Trip> Database::getTripAt(BufferRowIndex rowIndex) const
 {
 	assert(databaseLoaded);
 	
-	const QList<QVariant>* row = tripsTable.getBufferRow(rowIndex);
-	assert(row->size() == tripsTable.getNumberOfColumns());
+	const QList<QVariant> row = tripsTable.getBufferRow(rowIndex);
+	assert(row.size() == tripsTable.getNumberOfColumns());
 	
-	ValidItemID tripID = VALID_ITEM_ID(row->at(tripsTable.primaryKeyColumn.getIndex()));
-	QString	name		= row->at(tripsTable.nameColumn			.getIndex()).toString();
-	QDate	startDate	= row->at(tripsTable.startDateColumn	.getIndex()).toDate();
-	QDate	endDate		= row->at(tripsTable.endDateColumn		.getIndex()).toDate();
-	QString	description	= row->at(tripsTable.descriptionColumn	.getIndex()).toString();
+	ValidItemID tripID = VALID_ITEM_ID(row.at(tripsTable.primaryKeyColumn.getIndex()));
+	QString	name		= row.at(tripsTable.nameColumn			.getIndex()).toString();
+	QDate	startDate	= row.at(tripsTable.startDateColumn	.getIndex()).toDate();
+	QDate	endDate		= row.at(tripsTable.endDateColumn		.getIndex()).toDate();
+	QString	description	= row.at(tripsTable.descriptionColumn	.getIndex()).toString();
 	
 	return make_unique<Trip>(tripID, name, startDate, endDate, description);
 }
@@ -494,11 +580,11 @@ unique_ptr<Hiker> Database::getHikerAt(BufferRowIndex rowIndex) const
 {
 	assert(databaseLoaded);
 	
-	const QList<QVariant>* row = hikersTable.getBufferRow(rowIndex);
-	assert(row->size() == hikersTable.getNumberOfColumns());
+	const QList<QVariant> row = hikersTable.getBufferRow(rowIndex);
+	assert(row.size() == hikersTable.getNumberOfColumns());
 	
-	ValidItemID hikerID = VALID_ITEM_ID(row->at(hikersTable.primaryKeyColumn.getIndex()));
-	QString	name	= row->at(hikersTable.nameColumn.getIndex()).toString();
+	ValidItemID hikerID = VALID_ITEM_ID(row.at(hikersTable.primaryKeyColumn.getIndex()));
+	QString	name	= row.at(hikersTable.nameColumn.getIndex()).toString();
 	
 	return make_unique<Hiker>(hikerID, name);
 }
@@ -516,13 +602,13 @@ unique_ptr<Region> Database::getRegionAt(BufferRowIndex rowIndex) const
 {
 	assert(databaseLoaded);
 	
-	const QList<QVariant>* row = regionsTable.getBufferRow(rowIndex);
-	assert(row->size() == regionsTable.getNumberOfColumns());
+	const QList<QVariant> row = regionsTable.getBufferRow(rowIndex);
+	assert(row.size() == regionsTable.getNumberOfColumns());
 	
-	ValidItemID regionID = VALID_ITEM_ID(row->at(regionsTable.primaryKeyColumn.getIndex()));
-	QString	name		= row->at(regionsTable.nameColumn		.getIndex()).toString();
-	ItemID	rangeID		= row->at(regionsTable.rangeIDColumn	.getIndex()).toInt();
-	ItemID	countryID	= row->at(regionsTable.countryIDColumn	.getIndex()).toInt();
+	ValidItemID regionID = VALID_ITEM_ID(row.at(regionsTable.primaryKeyColumn.getIndex()));
+	QString	name		= row.at(regionsTable.nameColumn		.getIndex()).toString();
+	ItemID	rangeID		= row.at(regionsTable.rangeIDColumn	.getIndex()).toInt();
+	ItemID	countryID	= row.at(regionsTable.countryIDColumn	.getIndex()).toInt();
 	
 	return make_unique<Region>(regionID, name, rangeID, countryID);
 }
@@ -540,12 +626,12 @@ unique_ptr<Range> Database::getRangeAt(BufferRowIndex rowIndex) const
 {
 	assert(databaseLoaded);
 	
-	const QList<QVariant>* row = rangesTable.getBufferRow(rowIndex);
-	assert(row->size() == rangesTable.getNumberOfColumns());
+	const QList<QVariant> row = rangesTable.getBufferRow(rowIndex);
+	assert(row.size() == rangesTable.getNumberOfColumns());
 	
-	ValidItemID rangeID = VALID_ITEM_ID(row->at(rangesTable.primaryKeyColumn.getIndex()));
-	QString	name		= row->at(rangesTable.nameColumn		.getIndex()).toString();
-	int		continent	= row->at(rangesTable.continentColumn	.getIndex()).toInt();
+	ValidItemID rangeID = VALID_ITEM_ID(row.at(rangesTable.primaryKeyColumn.getIndex()));
+	QString	name		= row.at(rangesTable.nameColumn		.getIndex()).toString();
+	int		continent	= row.at(rangesTable.continentColumn	.getIndex()).toInt();
 	
 	return make_unique<Range>(rangeID, name, continent);
 }
@@ -563,11 +649,11 @@ unique_ptr<Country> Database::getCountryAt(BufferRowIndex rowIndex) const
 {
 	assert(databaseLoaded);
 	
-	const QList<QVariant>* row = countriesTable.getBufferRow(rowIndex);
-	assert(row->size() == countriesTable.getNumberOfColumns());
+	const QList<QVariant> row = countriesTable.getBufferRow(rowIndex);
+	assert(row.size() == countriesTable.getNumberOfColumns());
 	
-	ValidItemID countryID = VALID_ITEM_ID(row->at(countriesTable.primaryKeyColumn.getIndex()));
-	QString	name	= row->at(countriesTable.nameColumn.getIndex()).toString();
+	ValidItemID countryID = VALID_ITEM_ID(row.at(countriesTable.primaryKeyColumn.getIndex()));
+	QString	name	= row.at(countriesTable.nameColumn.getIndex()).toString();
 	
 	return make_unique<Country>(countryID, name);
 }
@@ -731,31 +817,55 @@ void Database::registerChangeListener(const TableChangeListener* listener)
 /**
  * Announces that one or more methods modifying data in the database are about to be called.
  * 
- * This method has to be called before a sequence of data-modifying methods is called. It does not
- * serve any purpose other than preventing the frontend to make changes without flushing change
- * notifications after all changes have been made. This is done using finishChangingData().
+ * This method has to be called before a sequence of data-modifying methods is called. It prevents
+ * the frontend from making changes without flushing change notifications after all changes have
+ * been made, which is done using finishChangingData(). It also notifies all change listeners, so
+ * that any background work reading the database can be finished first.
+ * 
+ * All changes made until finishChangingData() is called are written in a single SQL transaction,
+ * so that they are committed to disk at once instead of one statement at a time. If any statement
+ * fails, the transaction is rolled back before the application exits.
  */
 void Database::beginChangingData()
 {
 	assert(!acceptDataModifications);
+	assert(!changesTransactionOpen);
+	
+	for (const TableChangeListener* const listener : std::as_const(changeListeners)) {
+		listener->dataAboutToChange();
+	}
+	
 	acceptDataModifications = true;
+	// If no transaction can be opened, statements are committed individually
+	changesTransactionOpen = QSqlDatabase::database().transaction();
 }
 
 /**
  * Announce that changes to the data have been completed and all change notifications should be
  * flushed.
+ * 
+ * Commits the transaction opened in beginChangingData().
  */
 void Database::finishChangingData()
 {
 	assert(acceptDataModifications);
 	acceptDataModifications = false;
 	
+	if (changesTransactionOpen) {
+		changesTransactionOpen = false;
+		QSqlDatabase sql = QSqlDatabase::database();
+		if (!sql.commit()) {
+			displayError(sql.lastError());
+		}
+	}
+	
 	for (const TableChangeListener* const listener : std::as_const(changeListeners)) {
-		listener->dataChanged(changedColumns, rowsAddedOrRemovedPerTable);
+		listener->dataChanged(changedColumns, rowsAddedOrRemovedPerTable, changedRowsPerColumn);
 	}
 	
 	changedColumns.clear();
 	rowsAddedOrRemovedPerTable.clear();
+	changedRowsPerColumn.clear();
 }
 
 /**
@@ -801,6 +911,20 @@ void Database::rowsAdded(const Table& table, const QSet<BufferRowIndex>& addedRo
 	columnDataChanged(table.columns);
 }
 
+/**
+ * Notifies the database that the cells in the given column have changed in the given rows.
+ * 
+ * To be called by the application backend when existing rows in a table are modified.
+ * 
+ * @param column		The column in which cells have been changed.
+ * @param changedRows	The buffer row indices of the changed cells.
+ */
+void Database::cellsChanged(const Column& column, const QSet<BufferRowIndex>& changedRows)
+{
+	changedRowsPerColumn[&column].unite(changedRows);
+	columnDataChanged(&column);
+}
+
 /**
  * Notifies the database that the data in the given column has changed.
  * 
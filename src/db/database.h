@@ -68,10 +68,14 @@ class Database {
 	QSet<const TableChangeListener*> changeListeners;
 	/** Indicates whether the database is currently accepting changes to its data. */
 	bool acceptDataModifications;
+	/** Indicates whether an SQL transaction is open for the changes currently being made. */
+	bool changesTransactionOpen;
 	/** The set of columns whose data has been changed since the last changes flush. */
 	QSet<const Column*> changedColumns;
 	/** An index list of rows that have been added or removed since the last changes flush, mapped to their table. In the list of pairs, the bool indicates an added row if true, and a removed row if false. */
 	QHash<const Table*, QList<QPair<BufferRowIndex, bool>>> rowsAddedOrRemovedPerTable;
+	/** The buffer row indices of all cells that have been changed since the last changes flush, mapped to their column. Does not include added or removed rows. */
+	QHash<const Column*, QSet<BufferRowIndex>> changedRowsPerColumn;
 	
 	/** A precomputed matrix of breadcrumb connections from any normal table to any other normal table in the project (settings table always excluded). */
 	QMap<const NormalTable*, QMap<const NormalTable*, Breadcrumbs>> breadcrumbMatrix;
@@ -108,9 +112,14 @@ public:
 	void reset();
 	void createNew(QWidget& parent, const QString& filepath);
 	bool openExisting(QWidget& parent, const QString& filepath);
-	bool saveAs(QWidget& parent, const QString& filepath);
+	bool saveAs(QWidget& parent, const QString& filepath, bool& canceled);
 	QString getCurrentFilepath() const;
 	
+	void applyPerformanceProfile(QWidget& parent);
+private:
+	void optimizeBeforeClosing();
+public:
+	
 	void populateBuffers(QWidget& parent);
 	
 	QList<Table*> getItemTableList() const;
@@ -148,6 +157,7 @@ public:
 protected:
 	void rowsRemoved(const Table& table, const QSet<BufferRowIndex>& removedRows);
 	void rowsAdded(const Table& table, const QSet<BufferRowIndex>& addedRows);
+	void cellsChanged(const Column& column, const QSet<BufferRowIndex>& changedRows);
 	void columnDataChanged(const Column* affectedColumn);
 	void columnDataChanged(const QSet<const Column*>& affectedColumns);
 	void columnDataChanged(const QList<const Column*>& affectedColumns);
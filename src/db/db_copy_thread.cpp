@@ -0,0 +1,340 @@
+/*
+ * Copyright 2023-2025 Simon Vetter
+ * 
+ * This file is part of PeakAscentLogger.
+ * 
+ * PeakAscentLogger is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ * 
+ * PeakAscentLogger is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License along with PeakAscentLogger.
+ * If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file db_copy_thread.cpp
+ * 
+ * This file defines the DatabaseCopyThread class.
+ */
+
+#include "db_copy_thread.h"
+
+#include "src/db/database.h"
+
+#include <QEventLoop>
+#include <QFile>
+#include <QProgressDialog>
+#include <QSqlError>
+#include <QSqlQuery>
+
+#include <limits>
+
+
+
+const int DatabaseCopyThread::rowsPerStep = 500;
+
+
+
+/**
+ * Creates a new DatabaseCopyThread.
+ * 
+ * @param parent			The parent object of this thread.
+ * @param sourceFilepath	The filepath of the database file to copy.
+ * @param targetFilepath	The filepath of the copy to create. The file must not exist yet.
+ */
+DatabaseCopyThread::DatabaseCopyThread(QObject* parent, const QString& sourceFilepath, const QString& targetFilepath) :
+	QThread(parent),
+	sourceFilepath(sourceFilepath),
+	targetFilepath(targetFilepath),
+	connectionName("DatabaseCopyThread"),
+	abortWasCalled(false),
+	success(false)
+{
+	assert(!QFile(targetFilepath).exists());
+}
+
+
+
+/**
+ * Starts the thread.
+ * 
+ * Opens a separate connection to the new file, attaches the source file to it and copies the
+ * schema and all table contents over in a single transaction. The contents are copied in steps of
+ * at most rowsPerStep rows, after each of which the progress is reported back via the callback
+ * signal callback_reportProgress().
+ * 
+ * If abort() is called while the thread is running, the thread will stop after completing the
+ * current step. If the copy is aborted or fails, the incomplete new file is removed again.
+ */
+void DatabaseCopyThread::run()
+{
+	{
+		QSqlDatabase sql = QSqlDatabase::addDatabase("QSQLITE", connectionName);
+		sql.setDatabaseName(targetFilepath);
+		
+		if (sql.open()) {
+			success = copyDatabase(sql);
+			sql.close();
+		} else {
+			qDebug() << "Opening database copy failed:" << sql.lastError().text();
+		}
+	}
+	QSqlDatabase::removeDatabase(connectionName);
+	
+	if (!success) {
+		QFile(targetFilepath).remove();
+	}
+}
+
+/**
+ * Gracefully aborts the thread.
+ */
+void DatabaseCopyThread::abort()
+{
+	abortWasCalled = true;
+}
+
+/**
+ * Indicates whether the thread has completed the copy successfully.
+ * 
+ * @return	True if the copy was completed successfully, false if it failed, was aborted or is still running.
+ */
+bool DatabaseCopyThread::wasSuccessful() const
+{
+	return success;
+}
+
+/**
+ * Indicates whether the copy was aborted before it could be completed.
+ * 
+ * @return	True if abort() was called and the copy was not completed, false otherwise.
+ */
+bool DatabaseCopyThread::wasAborted() const
+{
+	return abortWasCalled && !success;
+}
+
+
+
+/**
+ * Copies the given database file to the given new filepath on a worker thread and shows a modal
+ * progress dialog, which allows the user to cancel the copy, until it is finished.
+ * 
+ * @param parent			The parent window.
+ * @param sourceFilepath	The filepath of the database file to copy.
+ * @param targetFilepath	The filepath of the copy to create. The file must not exist yet.
+ * @param labelText			The translated text to show in the progress dialog.
+ * @param canceled			Set to whether the copy was canceled by the user, as opposed to having failed or succeeded.
+ * @return					True if the copy was created successfully, false if it failed or was canceled.
+ */
+bool DatabaseCopyThread::copyWithProgressDialog(QWidget& parent, const QString& sourceFilepath, const QString& targetFilepath, const QString& labelText, bool& canceled)
+{
+	QProgressDialog progressDialog(labelText, Database::tr("Cancel"), 0, 0, &parent);
+	progressDialog.setWindowModality(Qt::WindowModal);
+	progressDialog.setMinimumDuration(500);
+	
+	DatabaseCopyThread copyThread(nullptr, sourceFilepath, targetFilepath);
+	QEventLoop eventLoop;
+	
+	connect(&copyThread,		&DatabaseCopyThread::callback_reportWorkloadSize,	&progressDialog,	&QProgressDialog::setMaximum);
+	connect(&copyThread,		&DatabaseCopyThread::callback_reportProgress,		&progressDialog,	&QProgressDialog::setValue);
+	connect(&copyThread,		&DatabaseCopyThread::finished,						&eventLoop,			&QEventLoop::quit);
+	connect(&progressDialog,	&QProgressDialog::canceled,							&copyThread,		&DatabaseCopyThread::abort);
+	
+	copyThread.start();
+	eventLoop.exec();
+	copyThread.wait();
+	
+	canceled = copyThread.wasAborted();
+	return copyThread.wasSuccessful();
+}
+
+
+
+/**
+ * Copies the schema and contents of the source file into the new file open on the given
+ * connection.
+ * 
+ * The copy is done in a single transaction, so that it reflects one consistent state of the
+ * source file and is either written completely or not at all. The user version and application ID
+ * stored in the file header are copied as well.
+ * 
+ * @param sql	The open connection to the new file.
+ * @return		True if the copy was completed, false if it failed or was aborted.
+ */
+bool DatabaseCopyThread::copyDatabase(QSqlDatabase& sql)
+{
+	QSqlQuery query = QSqlQuery(sql);
+	
+	query.prepare("ATTACH DATABASE ? AS source");
+	query.bindValue(0, sourceFilepath);
+	if (!query.exec()) {
+		qDebug() << "Attaching database to copy failed:" << query.lastError().text();
+		return false;
+	}
+	
+	if (!sql.transaction()) {
+		qDebug() << "Starting transaction for database copy failed:" << sql.lastError().text();
+		return false;
+	}
+	
+	// Read schema, with tables first so that all other objects can refer to them
+	QStringList tableNames = QStringList();
+	QStringList tableStatements = QStringList();
+	QStringList otherStatements = QStringList();
+	QString queryString = QString(
+		"SELECT type, name, sql FROM source.sqlite_master"
+		"\nWHERE sql IS NOT NULL AND name NOT LIKE 'sqlite_%'"
+		"\nORDER BY rowid"
+	);
+	if (!query.exec(queryString)) {
+		qDebug() << "Reading schema for database copy failed:" << query.lastError().text();
+		sql.rollback();
+		return false;
+	}
+	while (query.next()) {
+		if (query.value(0).toString() == "table") {
+			tableNames.append(query.value(1).toString());
+			tableStatements.append(query.value(2).toString());
+		} else {
+			otherStatements.append(query.value(2).toString());
+		}
+	}
+	
+	// Determine workload size
+	int workloadSize = 0;
+	for (const QString& tableName : std::as_const(tableNames)) {
+		if (!query.exec("SELECT COUNT(*) FROM source." + tableName) || !query.next()) {
+			qDebug() << "Counting rows for database copy failed:" << query.lastError().text();
+			sql.rollback();
+			return false;
+		}
+		workloadSize += query.value(0).toInt();
+	}
+	emit callback_reportWorkloadSize(workloadSize);
+	
+	// Create tables and copy contents
+	for (const QString& statement : std::as_const(tableStatements)) {
+		if (!query.exec(statement)) {
+			qDebug() << "Creating table in database copy failed:" << query.lastError().text();
+			sql.rollback();
+			return false;
+		}
+	}
+	int rowsCopied = 0;
+	for (const QString& tableName : std::as_const(tableNames)) {
+		if (!copyTableContents(sql, tableName, rowsCopied)) {
+			sql.rollback();
+			return false;
+		}
+	}
+	
+	// Create indices and all other objects only after the contents are in place
+	for (const QString& statement : std::as_const(otherStatements)) {
+		if (!query.exec(statement)) {
+			qDebug() << "Creating schema object in database copy failed:" << query.lastError().text();
+			sql.rollback();
+			return false;
+		}
+	}
+	
+	if (!copyHeaderPragmas(query)) {
+		sql.rollback();
+		return false;
+	}
+	
+	if (abortWasCalled || !sql.commit()) {
+		qDebug() << "Finishing database copy failed or was aborted:" << sql.lastError().text();
+		sql.rollback();
+		return false;
+	}
+	return true;
+}
+
+/**
+ * Copies the header fields which are not part of the schema, the user version and the application
+ * ID, from the attached source file into the new file.
+ * 
+ * @param query	A query on the open connection to the new file.
+ * @return		True if the header fields were copied, false if copying failed.
+ */
+bool DatabaseCopyThread::copyHeaderPragmas(QSqlQuery& query)
+{
+	for (const QString& pragma : {QString("user_version"), QString("application_id")}) {
+		if (!query.exec("PRAGMA source." + pragma) || !query.next()) {
+			qDebug() << "Reading" << pragma << "for database copy failed:" << query.lastError().text();
+			return false;
+		}
+		const qint64 value = query.value(0).toLongLong();
+		if (!query.exec("PRAGMA main." + pragma + " = " + QString::number(value))) {
+			qDebug() << "Writing" << pragma << "for database copy failed:" << query.lastError().text();
+			return false;
+		}
+	}
+	return true;
+}
+
+/**
+ * Copies the contents of one table from the attached source file into the same table in the new
+ * file, in steps of at most rowsPerStep rows in the order of their row IDs.
+ * 
+ * @param sql			The open connection to the new file.
+ * @param tableName		The name of the table to copy.
+ * @param rowsCopied	The number of rows copied so far in total, which is increased accordingly.
+ * @return				True if the table was copied completely, false if copying failed or was aborted.
+ */
+bool DatabaseCopyThread::copyTableContents(QSqlDatabase& sql, const QString& tableName, int& rowsCopied)
+{
+	QString stepEndQueryString = QString(
+		"SELECT rowid FROM source." + tableName +
+		"\nWHERE rowid > ?"
+		"\nORDER BY rowid LIMIT 1 OFFSET " + QString::number(rowsPerStep - 1)
+	);
+	QString stepQueryString = QString(
+		"INSERT INTO main." + tableName +
+		"\nSELECT * FROM source." + tableName +
+		"\nWHERE rowid > ? AND rowid <= ?"
+	);
+	QSqlQuery stepEndQuery = QSqlQuery(sql);
+	QSqlQuery stepQuery = QSqlQuery(sql);
+	if (!stepEndQuery.prepare(stepEndQueryString) || !stepQuery.prepare(stepQueryString)) {
+		qDebug() << "Preparing copy of table" << tableName << "failed:" << sql.lastError().text();
+		return false;
+	}
+	
+	qlonglong stepStartRowid = std::numeric_limits<qlonglong>::min();
+	bool lastStep = false;
+	while (!lastStep) {
+		if (abortWasCalled) return false;
+		
+		// Find the last row of this step, or copy all remaining rows if there are too few left
+		stepEndQuery.bindValue(0, stepStartRowid);
+		if (!stepEndQuery.exec()) {
+			qDebug() << "Copying table" << tableName << "failed:" << stepEndQuery.lastError().text();
+			return false;
+		}
+		qlonglong stepEndRowid = std::numeric_limits<qlonglong>::max();
+		if (stepEndQuery.next()) {
+			stepEndRowid = stepEndQuery.value(0).toLongLong();
+		} else {
+			lastStep = true;
+		}
+		stepEndQuery.finish();
+		
+		stepQuery.bindValue(0, stepStartRowid);
+		stepQuery.bindValue(1, stepEndRowid);
+		if (!stepQuery.exec()) {
+			qDebug() << "Copying table" << tableName << "failed:" << stepQuery.lastError().text();
+			return false;
+		}
+		
+		rowsCopied += stepQuery.numRowsAffected();
+		emit callback_reportProgress(rowsCopied);
+		stepStartRowid = stepEndRowid;
+	}
+	return true;
+}
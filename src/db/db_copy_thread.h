@@ -0,0 +1,91 @@
+/*
+ * Copyright 2023-2025 Simon Vetter
+ * 
+ * This file is part of PeakAscentLogger.
+ * 
+ * PeakAscentLogger is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ * 
+ * PeakAscentLogger is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License along with PeakAscentLogger.
+ * If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file db_copy_thread.h
+ * 
+ * This file declares the DatabaseCopyThread class.
+ */
+
+#ifndef DB_COPY_THREAD_H
+#define DB_COPY_THREAD_H
+
+#include <QThread>
+#include <QSqlDatabase>
+#include <QWidget>
+
+
+
+/**
+ * A thread that copies a database file through its own SQLite connection, step by step.
+ * 
+ * Since the copy is read through SQLite rather than from the file system, it is consistent and
+ * complete regardless of the journal mode of the source, and the application's own connection to
+ * the source file can stay open throughout.
+ */
+class DatabaseCopyThread : public QThread
+{
+	Q_OBJECT
+	
+	/** The filepath of the database file to copy. */
+	const QString sourceFilepath;
+	/** The filepath of the copy to create. */
+	const QString targetFilepath;
+	/** The name of the database connection used by the thread. */
+	const QString connectionName;
+	
+	/** Indicates whether an abort was requested. */
+	bool abortWasCalled;
+	/** Indicates whether the copy was completed successfully. */
+	bool success;
+	
+	/** The maximum number of rows copied in one step, between which progress is reported and abort requests are handled. */
+	static const int rowsPerStep;
+	
+public:
+	DatabaseCopyThread(QObject* parent, const QString& sourceFilepath, const QString& targetFilepath);
+	
+	void run() override;
+	void abort();
+	bool wasSuccessful() const;
+	bool wasAborted() const;
+	
+	static bool copyWithProgressDialog(QWidget& parent, const QString& sourceFilepath, const QString& targetFilepath, const QString& labelText, bool& canceled);
+	
+private:
+	bool copyDatabase(QSqlDatabase& sql);
+	bool copyHeaderPragmas(QSqlQuery& query);
+	bool copyTableContents(QSqlDatabase& sql, const QString& tableName, int& rowsCopied);
+	
+signals:
+	/**
+	 * Emitted when the thread has determined the number of rows to copy.
+	 * 
+	 * @param workloadSize	The number of rows to copy.
+	 */
+	void callback_reportWorkloadSize(int workloadSize);
+	/**
+	 * Emitted whenever the thread has finished copying one step.
+	 * 
+	 * @param rowsCopied	The number of rows copied so far.
+	 */
+	void callback_reportProgress(int rowsCopied);
+};
+
+
+
+#endif // DB_COPY_THREAD_H
@@ -26,9 +26,26 @@
 #include "database.h"
 
 #include <QMessageBox>
+#include <QSqlDatabase>
 
 
 
+/**
+ * Displays an error message and exits.
+ * 
+ * Any uncommitted changes are rolled back first, so that the database file is left in the state
+ * it was in before the current sequence of changes.
+ * 
+ * @param parent	The parent window, or nullptr.
+ * @param error		The error message.
+ */
+static void displayErrorAndExit(QWidget* parent, QString error)
+{
+	QSqlDatabase::database().rollback();
+	QMessageBox::critical(parent, Database::tr("Database error"), error);
+	exit(1);
+}
+
 /**
  * Displays an error message.
  * 
@@ -37,8 +54,7 @@
  */
 void displayError(QWidget& parent, QString error)
 {
-	QMessageBox::critical(&parent, Database::tr("Database error"), error);
-	exit(1);
+	displayErrorAndExit(&parent, error);
 }
 
 /**
@@ -90,3 +106,13 @@ void displayError(QWidget& parent, QSqlError error)
 {
 	return displayError(parent, formatSqlError(error));
 }
+
+/**
+ * Displays a QSqlError as an error message without a parent window.
+ * 
+ * @param error	The error.
+ */
+void displayError(QSqlError error)
+{
+	return displayErrorAndExit(nullptr, formatSqlError(error));
+}
@@ -36,6 +36,7 @@ QString formatSqlError(QSqlError error);
 void displayError(QWidget& parent, QString error, QString& queryString);
 void displayError(QWidget& parent, QSqlError error);
 void displayError(QWidget& parent, QSqlError error, QString& queryString);
+void displayError(QSqlError error);
 
 
 
@@ -23,6 +23,7 @@
 
 #include "db_upgrade.h"
 
+#include "src/db/db_copy_thread.h"
 #include "src/db/db_error.h"
 #include "src/main/helpers.h"
 
@@ -81,6 +82,7 @@ bool DatabaseUpgrader::checkDatabaseVersionAndUpgrade(std::function<void ()> exe
 	if (!versionOlderThan(currentDbVersion, appVersion)) {
 		// No upgrade necessary
 		executeAfterStructuralUpgrade();
+		createMissingForeignKeyIndices();
 		return true;
 	}
 	
@@ -148,6 +150,10 @@ bool DatabaseUpgrader::checkDatabaseVersionAndUpgrade(std::function<void ()> exe
 		db.settingsTable.removeAllMatchingSettings(parent, "implicit/mainWindow/showFilters");
 	}
 	
+	// Any version
+	// Indices don't change the file format, so they are added regardless of version
+	createMissingForeignKeyIndices();
+	
 	
 	// Set new version
 	if (versionOlderThan(currentDbVersion, appVersion)) {
@@ -275,7 +281,7 @@ bool DatabaseUpgrader::showOutdatedAppWarningAndBackup(const QString& dbVersion)
 
 /**
  * Creates a backup copy of the project file and asks the user whether to continue if the copy
- * fails.
+ * fails or is canceled.
  * 
  * @param confirmationQuestion	Translated string to insert into the message, asking the user whether to continue if the backup failed.
  * @param currentDbVersion		A string with the database's current (old) version.
@@ -294,15 +300,28 @@ bool DatabaseUpgrader::createFileBackupCopy(const QString& confirmationQuestion,
 	}
 	
 	// Copy file
-	if (!QFile(filepath).copy(backupFilepath)) {
-		qDebug() << "File copy failed:" << filepath << "to" << backupFilepath;
+	QString labelText = Database::tr("Creating backup of project file...");
+	bool canceled = false;
+	if (!DatabaseCopyThread::copyWithProgressDialog(parent, filepath, backupFilepath, labelText, canceled)) {
+		qDebug() << (canceled ? "File copy was canceled:" : "File copy failed:") << filepath << "to" << backupFilepath;
 		// Ask user whether to continue
-		QString windowTitle = Database::tr("Error creating backup");
-		QString message = filepath + "\n\n"
-			+ Database::tr("An error occurred while trying to create a backup of the project file."
-				"\n%1"
-				"\n\nNote: You can still create a backup manually before proceeding.")
-			.arg(confirmationQuestion);
+		QString windowTitle;
+		QString message;
+		if (canceled) {
+			windowTitle = Database::tr("Backup canceled");
+			message = filepath + "\n\n"
+				+ Database::tr("Creating a backup of the project file was canceled."
+					"\n%1"
+					"\n\nNote: You can still create a backup manually before proceeding.")
+				.arg(confirmationQuestion);
+		} else {
+			windowTitle = Database::tr("Error creating backup");
+			message = filepath + "\n\n"
+				+ Database::tr("An error occurred while trying to create a backup of the project file."
+					"\n%1"
+					"\n\nNote: You can still create a backup manually before proceeding.")
+				.arg(confirmationQuestion);
+		}
 		auto buttons = QMessageBox::Yes | QMessageBox::No | QMessageBox::Cancel;
 		auto defaultButton = QMessageBox::Cancel;
 		
@@ -327,6 +346,27 @@ void DatabaseUpgrader::showUpgradeSuccessMessage(const QString& previousVersion,
 	QMessageBox::information(&parent, windowTitle, message);
 }
 
+/**
+ * Creates the indices on all foreign key columns which don't exist yet in the open database.
+ * 
+ * Files created before the indices were introduced lack them. Since adding an index doesn't change
+ * the file format and older versions of the app can still open the file, this is done for files of
+ * any older or the current version, including those which are otherwise up to date. Files created
+ * by newer versions of the app are left untouched, since their structure may differ.
+ * 
+ * Must only be called after the database structure has been checked, so that all indexed columns
+ * are known to exist. Since the indices are not needed for correctness, failing to create them
+ * (e.g. because the file is read-only) does not prevent opening the database.
+ */
+void DatabaseUpgrader::createMissingForeignKeyIndices()
+{
+	for (Table* const table : std::as_const(db.tables)) {
+		if (!table->createForeignKeyIndicesInSql()) {
+			qDebug() << "Could not create all foreign key indices for table" << table->name << "- continuing without them";
+		}
+	}
+}
+
 
 
 /**
@@ -51,6 +51,7 @@ private:
 	bool showOutdatedAppWarningAndBackup(const QString& dbVersion);
 	bool createFileBackupCopy(const QString& confirmationQuestion, const QString& currentDbVersion);
 	void showUpgradeSuccessMessage(const QString& previousVersion, const QString& newVersion);
+	void createMissingForeignKeyIndices();
 	
 	// Version-specific functions
 	ItemID extractDefaultHikerFromBeforeV1_2_0();
@@ -57,24 +57,6 @@ NormalTable::~NormalTable()
 
 // BUFFER ACCESS
 
-/**
- * Returns the index of the buffer row which contains the given primary key.
- * 
- * If the primary key is not found, an invalid BufferRowIndex is returned.
- * 
- * @param primaryKey	The primary key to search for.
- * @return				The index of the buffer row which contains the given primary key, or an invalid BufferRowIndex.
- */
-BufferRowIndex NormalTable::getBufferIndexForPrimaryKey(ValidItemID primaryKey) const
-{
-	BufferRowIndex index = BufferRowIndex(0);
-	for (const QList<QVariant>* const bufferRow : buffer) {
-		if (Q_UNLIKELY(bufferRow->at(0) == ID_GET(primaryKey))) return index;
-		index++;
-	}
-	return BufferRowIndex();
-}
-
 /**
  * Returns the primary key of the buffer row at the given index.
  * 
@@ -97,19 +79,19 @@ QList<QPair<ValidItemID, QVariant>> NormalTable::pairIDWith(const Column& column
 	const int primaryKeyColumnIndex = primaryKeyColumn.getIndex();
 	const int columnIndex = column.getIndex();
 	QList<QPair<ValidItemID, QVariant>> pairs = QList<QPair<ValidItemID, QVariant>>();
-	for (const QList<QVariant>* const bufferRow : buffer) {
-		const ValidItemID id = VALID_ITEM_ID(bufferRow->at(primaryKeyColumnIndex));
+	for (BufferRowIndex rowIndex = BufferRowIndex(0); rowIndex.isValid(buffer.numRows()); rowIndex++) {
+		const ValidItemID id = VALID_ITEM_ID(buffer.getCell(rowIndex, primaryKeyColumnIndex));
 		QVariant value = QVariant();
 		if (Q_UNLIKELY(column.foreignColumn)) {
 			assert(!column.foreignColumn->table.isAssociative);
 			const NormalTable& foreignTable = (const NormalTable&) column.foreignColumn->table;
-			const ItemID foreignID = ItemID(bufferRow->at(columnIndex));
+			const ItemID foreignID = ItemID(buffer.getCell(rowIndex, columnIndex));
 			if (foreignID.isValid()) {
 				const BufferRowIndex foreignRowIndex = foreignTable.getBufferIndexForPrimaryKey(FORCE_VALID(foreignID));
 				value = foreignTable.getIdentityRepresentationAt(foreignRowIndex);
 			}
 		} else {
-			value = bufferRow->at(columnIndex);
+			value = buffer.getCell(rowIndex, columnIndex);
 		}
 		pairs.append({id, value});
 	}
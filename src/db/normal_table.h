@@ -44,7 +44,6 @@ public:
 	virtual ~NormalTable();
 	
 	// Buffer access
-	BufferRowIndex getBufferIndexForPrimaryKey(ValidItemID primaryKey) const;
 	ValidItemID getPrimaryKeyAt(BufferRowIndex bufferRowIndex) const;
 	QList<QPair<ValidItemID, QVariant>> pairIDWith(const Column& column) const;
 	
@@ -46,7 +46,10 @@ Table::Table(Database& db, QString name, QString uiName, bool isAssociative) :
 	name(name),
 	uiName(uiName),
 	isAssociative(isAssociative),
-	buffer(TableBuffer())
+	buffer(TableBuffer()),
+	primaryKeyIndex(QHash<ValidItemID, BufferRowIndex>()),
+	foreignKeyIndices(QHash<const Column*, QHash<ValidItemID, QList<BufferRowIndex>>>()),
+	preparedQueries(std::map<PreparedQueryKey, unique_ptr<QSqlQuery>>())
 {}
 
 /**
@@ -235,15 +238,20 @@ const Column& Table::getColumnByIndex(int index) const
  */
 void Table::initBuffer(QWidget& parent)
 {
-	QList<QList<QVariant>*> newContents = getAllEntriesFromSql(parent);
+	const QList<QList<QVariant>> newContents = getAllEntriesFromSql(parent);
 	int last = newContents.size() - 1;
 	if (last < 0) last = 0;
 	beginInsertRows(getNormalRootModelIndex(), 0, last);
 	buffer.reset();
-	buffer.setInitialNumberOfColumns(columns.size());
-	for (QList<QVariant>* const newRow : std::as_const(newContents)) {
+	QList<DataType> columnTypes = QList<DataType>();
+	for (const Column* const column : std::as_const(columns)) {
+		columnTypes.append(column->type);
+	}
+	buffer.setInitialColumnTypes(columnTypes);
+	for (const QList<QVariant>& newRow : newContents) {
 		buffer.appendRow(newRow);
 	}
+	rebuildIndices();
 	endInsertRows();
 }
 
@@ -255,6 +263,7 @@ void Table::resetBuffer()
 	const int last = buffer.numRows() - 1;
 	if (last >= 0) beginRemoveRows(getNormalRootModelIndex(), 0, last);
 	buffer.reset();
+	rebuildIndices();
 	if (last >= 0) endRemoveRows();
 }
 
@@ -269,27 +278,66 @@ int Table::getNumberOfRows() const
 }
 
 /**
- * Returns the row at the given index.
+ * Returns a copy of the row at the given index.
  * 
  * @param bufferRowIndex	The index of the row to return.
  * @return					The row at the given index.
  */
-const QList<QVariant>* Table::getBufferRow(BufferRowIndex bufferRowIndex) const
+QList<QVariant> Table::getBufferRow(BufferRowIndex bufferRowIndex) const
 {
 	return buffer.getRow(bufferRowIndex);
 }
 
+/**
+ * Returns the value of the cell at the given row and column index.
+ * 
+ * @param bufferRowIndex	The row index of the cell to return.
+ * @param columnIndex		The column index of the cell to return.
+ * @return					The value of the cell at the given location.
+ */
+QVariant Table::getBufferCell(BufferRowIndex bufferRowIndex, int columnIndex) const
+{
+	return buffer.getCell(bufferRowIndex, columnIndex);
+}
+
+/**
+ * Returns read access to the buffer of this table, so that other buffers can share its columns.
+ * 
+ * @return	The buffer of this table.
+ */
+const TableBuffer& Table::getBuffer() const
+{
+	return buffer;
+}
+
 /**
  * Collects indices of all rows in the table where the given column has the given value.
  * 
+ * For foreign key columns and the primary key column of normal tables, the lookup uses the
+ * respective buffer index and takes time proportional to the size of the result. For all other
+ * columns, the whole buffer is scanned.
+ * 
  * @param column	The column to check.
  * @param content	The value to check for.
- * @return			A list of all row indices in the table where the given column has the given value.
+ * @return			A list of all row indices in the table where the given column has the given value, in ascending order.
  */
 QList<BufferRowIndex> Table::getMatchingBufferRowIndices(const Column& column, const QVariant& content) const
 {
 	assert(getColumnList().contains(&column));
 	
+	const ItemID key = ItemID(content);
+	if (key.isValid()) {
+		const QHash<const Column*, QHash<ValidItemID, QList<BufferRowIndex>>>::const_iterator foreignKeyIndex = foreignKeyIndices.constFind(&column);
+		if (foreignKeyIndex != foreignKeyIndices.constEnd()) {
+			return foreignKeyIndex->value(FORCE_VALID(key));
+		}
+		if (!isAssociative && column.primaryKey) {
+			const BufferRowIndex bufferRowIndex = getBufferIndexForPrimaryKey(FORCE_VALID(key));
+			if (bufferRowIndex.isInvalid()) return {};
+			return { bufferRowIndex };
+		}
+	}
+	
 	QList<BufferRowIndex> result = QList<BufferRowIndex>();
 	for (BufferRowIndex rowIndex = BufferRowIndex(0); rowIndex.isValid(buffer.numRows()); rowIndex++) {
 		if (column.getValueAt(rowIndex) == content) {
@@ -315,6 +363,11 @@ BufferRowIndex Table::getMatchingBufferRowIndex(const QList<const Column*>& prim
 	assert(primaryKeyColumns.size() == numPrimaryKeys);
 	assert(primaryKeys.size() == numPrimaryKeys);
 	
+	if (!isAssociative) {
+		// Invalid if the primary key is not found
+		return getBufferIndexForPrimaryKey(primaryKeys.first());
+	}
+	
 	for (BufferRowIndex bufferRowIndex = BufferRowIndex(0); bufferRowIndex.isValid(buffer.numRows()); bufferRowIndex++) {
 		bool match = true;
 		for (int i = 0; i < numPrimaryKeys; i++) {
@@ -329,6 +382,24 @@ BufferRowIndex Table::getMatchingBufferRowIndex(const QList<const Column*>& prim
 	return BufferRowIndex();
 }
 
+/**
+ * Returns the index of the buffer row which contains the given primary key.
+ * 
+ * Uses the primary key index, so the lookup takes constant time.
+ * If the primary key is not found, an invalid BufferRowIndex is returned.
+ * 
+ * @pre The table is not associative.
+ * 
+ * @param primaryKey	The primary key to search for.
+ * @return				The index of the buffer row which contains the given primary key, or an invalid BufferRowIndex.
+ */
+BufferRowIndex Table::getBufferIndexForPrimaryKey(ValidItemID primaryKey) const
+{
+	assert(!isAssociative);
+	
+	return primaryKeyIndex.value(primaryKey, BufferRowIndex());
+}
+
 
 /**
  * Prints the contents of the buffer to the console for debugging purposes.
@@ -342,10 +413,10 @@ void Table::printBuffer() const
 		header.append(column->name + "  ");
 	}
 	qDebug() << header;
-	for (const QList<QVariant>* bufferRow : buffer) {
+	for (BufferRowIndex rowIndex = BufferRowIndex(0); rowIndex.isValid(buffer.numRows()); rowIndex++) {
 		QString rowString = "";
 		for (int columnIndex = 0; columnIndex < getNumberOfColumns(); columnIndex++) {
-			rowString.append(bufferRow->at(columnIndex).toString()).append("        ");
+			rowString.append(buffer.getCell(rowIndex, columnIndex).toString()).append("        ");
 		}
 		qDebug() << rowString;
 	}
@@ -375,14 +446,14 @@ BufferRowIndex Table::addRow(QWidget& parent, const QList<ColumnDataPair>& colum
 	ItemID newRowID = addRowToSql(parent, columnDataPairs);
 	
 	// Update buffer
-	QList<QVariant>* newBufferRow = new QList<QVariant>();
+	QList<QVariant> newBufferRow = QList<QVariant>();
 	for (const ColumnDataPair& columnDataPair : columnDataPairs) {
-		newBufferRow->append(columnDataPair.second);
+		newBufferRow.append(columnDataPair.second);
 	}
 	if (!isAssociative) {
-		newBufferRow->insert(0, newRowID.asQVariant());
+		newBufferRow.insert(0, newRowID.asQVariant());
 	}
-	buffer.appendRow(newBufferRow);
+	appendBufferRow(newBufferRow);
 	
 	// Announce end of row insertion
 	endInsertRows();
@@ -415,7 +486,7 @@ void Table::updateCellInNormalTable(QWidget& parent, const ValidItemID primaryKe
 	
 	// Update buffer
 	BufferRowIndex bufferRowIndex = getMatchingBufferRowIndex(primaryKeyColumns, { primaryKey });
-	buffer.replaceCell(bufferRowIndex, column.getIndex(), data);
+	replaceBufferCell(bufferRowIndex, column, data);
 	
 	// Announce changed data
 	QModelIndex updateIndexNormal	= index(bufferRowIndex.get(), column.getIndex(), getNormalRootModelIndex());
@@ -423,7 +494,7 @@ void Table::updateCellInNormalTable(QWidget& parent, const ValidItemID primaryKe
 	const QList<int> updatedDatumRoles = { column.type == Bit ? Qt::CheckStateRole : Qt::DisplayRole };
 	Q_EMIT dataChanged(updateIndexNormal, updateIndexNormal, updatedDatumRoles);
 	Q_EMIT dataChanged(updateIndexNullable, updateIndexNullable, updatedDatumRoles);
-	db.columnDataChanged(&column);
+	db.cellsChanged(column, { bufferRowIndex });
 }
 
 /**
@@ -453,7 +524,7 @@ void Table::updateRowsInNormalTable(QWidget& parent, const QSet<BufferRowIndex>&
 		
 		// Update buffer
 		for (const auto& [column, data] : columnDataPairs) {
-			buffer.replaceCell(bufferIndex, column->getIndex(), data);
+			replaceBufferCell(bufferIndex, *column, data);
 		}
 		
 		if (bufferIndex < minBufferRow) minBufferRow = bufferIndex;
@@ -466,7 +537,7 @@ void Table::updateRowsInNormalTable(QWidget& parent, const QSet<BufferRowIndex>&
 	const QList<int> updatedDatumRoles = { Qt::CheckStateRole, Qt::DisplayRole };
 	Q_EMIT dataChanged(updateIndexLeft, updateIndexRight, updatedDatumRoles);
 	for (const auto& [column, _] : columnDataPairs) {
-		db.columnDataChanged(column);
+		db.cellsChanged(*column, bufferIndices);
 	}
 	
 }
@@ -530,7 +601,7 @@ void Table::removeRow(QWidget& parent, const QList<const Column*>& primaryKeyCol
 	removeRowFromSql(parent, primaryKeyColumns, primaryKeys);
 	
 	// Update buffer
-	buffer.removeRow(bufferRowIndex);
+	removeBufferRow(bufferRowIndex);
 	
 	// Announce end of row removal
 	endRemoveRows();
@@ -565,7 +636,7 @@ void Table::removeMatchingRows(QWidget& parent, const Column& column, const QSet
 			BufferRowIndex bufferRowIndex = *iter;
 			beginRemoveRows(getNormalRootModelIndex(), bufferRowIndex.get(), bufferRowIndex.get());
 			
-			buffer.removeRow(bufferRowIndex);
+			removeBufferRow(bufferRowIndex);
 			
 			// Announce end of row removal
 			endRemoveRows();
@@ -591,12 +662,177 @@ void Table::removeMatchingRows(QWidget& parent, const Column& column, ValidItemI
 
 
 
+// BUFFER MODIFICATIONS
+
+/**
+ * Appends a row to the buffer and updates the buffer indices accordingly.
+ * 
+ * @param newRow	The row to append.
+ */
+void Table::appendBufferRow(const QList<QVariant>& newRow)
+{
+	const BufferRowIndex newRowIndex = BufferRowIndex(buffer.numRows());
+	buffer.appendRow(newRow);
+	addRowToAdditionalIndices(newRowIndex);
+	
+	if (!isAssociative) {
+		const ValidItemID primaryKey = VALID_ITEM_ID(newRow.at(0));
+		assert(!primaryKeyIndex.contains(primaryKey));
+		primaryKeyIndex.insert(primaryKey, newRowIndex);
+	}
+	
+	for (auto iter = foreignKeyIndices.begin(); iter != foreignKeyIndices.end(); ++iter) {
+		const ItemID key = ItemID(newRow.at(iter.key()->getIndex()));
+		if (key.isInvalid()) continue;
+		// New row has the highest index, so appending keeps the list sorted
+		(*iter)[FORCE_VALID(key)].append(newRowIndex);
+	}
+}
+
+/**
+ * Removes a row from the buffer and updates the buffer indices accordingly.
+ * 
+ * Since all subsequent rows move up by one, this takes linear time in the number of rows.
+ * 
+ * @param bufferRowIndex	The index of the row to remove.
+ */
+void Table::removeBufferRow(BufferRowIndex bufferRowIndex)
+{
+	if (!isAssociative) {
+		const ValidItemID primaryKey = VALID_ITEM_ID(buffer.getCell(bufferRowIndex, 0));
+		primaryKeyIndex.remove(primaryKey);
+		for (BufferRowIndex& indexedRow : primaryKeyIndex) {
+			if (indexedRow > bufferRowIndex) indexedRow = indexedRow - 1;
+		}
+	}
+	
+	for (auto iter = foreignKeyIndices.begin(); iter != foreignKeyIndices.end(); ++iter) {
+		const ItemID key = ItemID(buffer.getCell(bufferRowIndex, iter.key()->getIndex()));
+		if (key.isValid()) {
+			QList<BufferRowIndex>& rowsForKey = (*iter)[FORCE_VALID(key)];
+			rowsForKey.removeOne(bufferRowIndex);
+			if (rowsForKey.isEmpty()) iter->remove(FORCE_VALID(key));
+		}
+		for (QList<BufferRowIndex>& rowsForKey : *iter) {
+			for (BufferRowIndex& indexedRow : rowsForKey) {
+				if (indexedRow > bufferRowIndex) indexedRow = indexedRow - 1;
+			}
+		}
+	}
+	
+	removeRowFromAdditionalIndices(bufferRowIndex);
+	buffer.removeRow(bufferRowIndex);
+}
+
+/**
+ * Replaces the value of a cell in the buffer and updates the buffer indices accordingly.
+ * 
+ * @param bufferRowIndex	The row index of the cell to replace.
+ * @param column			The column of the cell to replace.
+ * @param newValue			The new value for the cell.
+ */
+void Table::replaceBufferCell(BufferRowIndex bufferRowIndex, const Column& column, const QVariant& newValue)
+{
+	const int columnIndex = column.getIndex();
+	
+	const QHash<const Column*, QHash<ValidItemID, QList<BufferRowIndex>>>::iterator foreignKeyIndex = foreignKeyIndices.find(&column);
+	if (foreignKeyIndex != foreignKeyIndices.end()) {
+		const ItemID oldKey = ItemID(buffer.getCell(bufferRowIndex, columnIndex));
+		const ItemID newKey = ItemID(newValue);
+		if (oldKey != newKey) {
+			if (oldKey.isValid()) {
+				QList<BufferRowIndex>& oldRowsForKey = (*foreignKeyIndex)[FORCE_VALID(oldKey)];
+				oldRowsForKey.removeOne(bufferRowIndex);
+				if (oldRowsForKey.isEmpty()) foreignKeyIndex->remove(FORCE_VALID(oldKey));
+			}
+			if (newKey.isValid()) {
+				QList<BufferRowIndex>& newRowsForKey = (*foreignKeyIndex)[FORCE_VALID(newKey)];
+				newRowsForKey.insert(std::lower_bound(newRowsForKey.begin(), newRowsForKey.end(), bufferRowIndex), bufferRowIndex);
+			}
+		}
+	}
+	
+	buffer.replaceCell(bufferRowIndex, columnIndex, newValue);
+}
+
+/**
+ * Discards and recreates all buffer indices from the current buffer contents.
+ */
+void Table::rebuildIndices()
+{
+	primaryKeyIndex.clear();
+	
+	if (!isAssociative) {
+		primaryKeyIndex.reserve(buffer.numRows());
+		for (BufferRowIndex rowIndex = BufferRowIndex(0); rowIndex.isValid(buffer.numRows()); rowIndex++) {
+			const ValidItemID primaryKey = VALID_ITEM_ID(buffer.getCell(rowIndex, 0));
+			primaryKeyIndex.insert(primaryKey, rowIndex);
+		}
+	}
+	
+	foreignKeyIndices.clear();
+	
+	for (const Column* const column : std::as_const(columns)) {
+		if (!column->foreignColumn) continue;
+		
+		QHash<ValidItemID, QList<BufferRowIndex>>& foreignKeyIndex = foreignKeyIndices[column];
+		const int columnIndex = column->getIndex();
+		for (BufferRowIndex rowIndex = BufferRowIndex(0); rowIndex.isValid(buffer.numRows()); rowIndex++) {
+			const ItemID key = ItemID(buffer.getCell(rowIndex, columnIndex));
+			if (key.isInvalid()) continue;
+			foreignKeyIndex[FORCE_VALID(key)].append(rowIndex);
+		}
+	}
+	
+	rebuildAdditionalIndices();
+}
+
+
+
+// ADDITIONAL BUFFER INDICES
+
+/**
+ * Discards and recreates any additional buffer indices a subclass maintains.
+ * 
+ * Called whenever the buffer has been filled or reset. Does nothing by default.
+ */
+void Table::rebuildAdditionalIndices()
+{}
+
+/**
+ * Adds the given, newly appended buffer row to any additional buffer indices a subclass
+ * maintains.
+ * 
+ * Does nothing by default.
+ * 
+ * @param bufferRowIndex	The index of the new row in the buffer.
+ */
+void Table::addRowToAdditionalIndices(BufferRowIndex bufferRowIndex)
+{
+	Q_UNUSED(bufferRowIndex);
+}
+
+/**
+ * Removes the given buffer row from any additional buffer indices a subclass maintains.
+ * 
+ * Called before the row is removed from the buffer. Does nothing by default.
+ * 
+ * @param bufferRowIndex	The index of the row which is about to be removed from the buffer.
+ */
+void Table::removeRowFromAdditionalIndices(BufferRowIndex bufferRowIndex)
+{
+	Q_UNUSED(bufferRowIndex);
+}
+
+
+
 // SQL
 
 /**
  * Creates the table in the SQL database.
  * 
  * Only needed when creating a new database or updating the project file version.
+ * Also creates the indices on the foreign key columns.
  * 
  * @param parent	The parent window.
  */
@@ -625,6 +861,45 @@ void Table::createTableInSql(QWidget& parent)
 	if (!query.exec(queryString)) {
 		displayError(parent, query.lastError(), queryString);
 	}
+	
+	createForeignKeyIndicesInSql();
+}
+
+/**
+ * Creates an index on every foreign key column of the table in the SQL database, unless it
+ * already exists.
+ * 
+ * SQLite does not index foreign key columns automatically, so without these, every lookup of the
+ * rows referencing a given item and every delete of a referenced item scans the whole table.
+ * The leading column of the primary key of an associative table is skipped, since the index of the
+ * primary key already covers it.
+ * 
+ * Since the indices only speed up queries, failing to create one is not an error. It is logged and
+ * the remaining indices are still created.
+ * 
+ * @return	True if all indices exist after the call, false if any of them could not be created.
+ */
+bool Table::createForeignKeyIndicesInSql()
+{
+	const Column* const coveredColumn = isAssociative ? getPrimaryKeyColumnList().first() : nullptr;
+	
+	bool success = true;
+	for (const Column* const column : getForeignKeyColumnList()) {
+		if (column == coveredColumn) continue;
+		
+		QString queryString = QString(
+			"CREATE INDEX IF NOT EXISTS " + name.toLower() + "_" + column->name + "_index" +
+			" ON " + name + "(" + column->name + ")"
+		);
+		qDebug() << queryString;
+		QSqlQuery query = QSqlQuery();
+		
+		if (!query.exec(queryString)) {
+			qDebug() << "Creating foreign key index failed:" << query.lastError().text();
+			success = false;
+		}
+	}
+	return success;
 }
 
 /**
@@ -656,7 +931,7 @@ void Table::addColumnInSql(QWidget& parent, const Column& column)
  * @param parent	The parent window.
  * @return			A two-dimensional list of QVariants containing the response to the SQL query.
  */
-QList<QList<QVariant>*> Table::getAllEntriesFromSql(QWidget& parent) const
+QList<QList<QVariant>> Table::getAllEntriesFromSql(QWidget& parent) const
 {
 	QString queryString = QString(
 			"SELECT " + getColumnListString() +
@@ -664,7 +939,7 @@ QList<QList<QVariant>*> Table::getAllEntriesFromSql(QWidget& parent) const
 	);
 	QSqlQuery query = QSqlQuery();
 	query.setForwardOnly(true);
-	QList<QList<QVariant>*> result = QList<QList<QVariant>*>();
+	QList<QList<QVariant>> result = QList<QList<QVariant>>();
 	
 	if (!query.exec(queryString)) {
 		displayError(parent, query.lastError(), queryString);
@@ -672,9 +947,9 @@ QList<QList<QVariant>*> Table::getAllEntriesFromSql(QWidget& parent) const
 	
 	const QList<const Column*> columns = getColumnList();
 	
-	int rowIndex = 0;
 	while (query.next()) {
-		result.append(new QList<QVariant>());
+		QList<QVariant> row = QList<QVariant>();
+		row.reserve(columns.size());
 		int columnIndex = 0;
 		for (const Column* column : columns) {
 			QVariant value = query.value(columnIndex);
@@ -687,10 +962,10 @@ QList<QList<QVariant>*> Table::getAllEntriesFromSql(QWidget& parent) const
 			}
 			assert(column->nullable || !value.isNull());
 			if (value.isNull()) value = QVariant();
-			result.at(rowIndex)->append(value);
+			row.append(value);
 			columnIndex++;
 		}
-		rowIndex++;
+		result.append(row);
 	}
 	
 	return result;
@@ -705,27 +980,17 @@ QList<QList<QVariant>*> Table::getAllEntriesFromSql(QWidget& parent) const
  */
 ValidItemID Table::addRowToSql(QWidget& parent, const QList<ColumnDataPair>& columnDataPairs)
 {
-	QString questionMarks = "";
+	QSqlQuery& query = getPreparedQuery(parent, AddRowQuery, getColumnsFrom(columnDataPairs));
 	for (int i = 0; i < columnDataPairs.size(); i++) {
-		questionMarks = questionMarks + ((i == 0) ? "?" : ", ?");
-	}
-	QString queryString = QString(
-			"INSERT INTO " + name + "(" + getColumnListStringFrom(columnDataPairs) + ")" +
-			"\nVALUES(" + questionMarks + ")"
-	);
-	QSqlQuery query = QSqlQuery();
-	if (!query.prepare(queryString)) {
-		displayError(parent, query.lastError(), queryString);
-	}
-	for (const ColumnDataPair& columnDataPair : columnDataPairs) {
-		query.addBindValue(columnDataPair.second);
+		query.bindValue(i, columnDataPairs.at(i).second);
 	}
 	
 	if (!query.exec()) {
-		displayError(parent, query.lastError(), queryString);
+		displayError(parent, query.lastError(), query.lastQuery());
 	}
 	
 	ValidItemID newRowID = VALID_ITEM_ID(query.lastInsertId().toInt());
+	query.finish();
 	return newRowID;
 }
 
@@ -741,22 +1006,14 @@ void Table::updateCellOfNormalTableInSql(QWidget& parent, const ValidItemID prim
 {
 	assert(!isAssociative);
 	
-	QList<const Column*> primaryKeyColumns = getPrimaryKeyColumnList();
-	const Column& primaryKeyColumn = *primaryKeyColumns.first();
-	
-	QString queryString = QString(
-			"UPDATE " + name +
-			"\nSET " + column.name + " = ?" +
-			"\nWHERE " + primaryKeyColumn.name + " = " + QString::number(ID_GET(primaryKey))
-	);
-	QSqlQuery query = QSqlQuery();
-	if (!query.prepare(queryString))
-		displayError(parent, query.lastError(), queryString);
-	query.addBindValue(data);
+	QSqlQuery& query = getPreparedQuery(parent, UpdateCellQuery, { &column });
+	query.bindValue(0, data);
+	query.bindValue(1, ID_GET(primaryKey));
 	
 	if (!query.exec()) {
-		displayError(parent, query.lastError(), queryString);
+		displayError(parent, query.lastError(), query.lastQuery());
 	}
+	query.finish();
 }
 
 /**
@@ -770,29 +1027,16 @@ void Table::updateRowInSql(QWidget& parent, const ValidItemID primaryKey, const
 {
 	assert(!columnDataPairs.isEmpty());
 	
-	QList<const Column*> primaryKeyColumns = getPrimaryKeyColumnList();
-	const Column& primaryKeyColumn = *primaryKeyColumns.first();
-	
-	QString setString = "";
-	for (const auto& [column, data] : columnDataPairs) {
-		if (!setString.isEmpty()) setString.append(", ");
-		setString.append(column->name).append(" = ?");
-	}
-	QString queryString = QString(
-			"UPDATE " + name +
-			"\nSET " + setString +
-			"\nWHERE " + primaryKeyColumn.name + " = " + QString::number(ID_GET(primaryKey))
-	);
-	QSqlQuery query = QSqlQuery();
-	if (!query.prepare(queryString))
-		displayError(parent, query.lastError(), queryString);
+	QSqlQuery& query = getPreparedQuery(parent, UpdateRowQuery, getColumnsFrom(columnDataPairs));
 	for (int i = 0; i < columnDataPairs.size(); i++) {
-		query.addBindValue(columnDataPairs.at(i).second);
+		query.bindValue(i, columnDataPairs.at(i).second);
 	}
+	query.bindValue(columnDataPairs.size(), ID_GET(primaryKey));
 	
 	if (!query.exec()) {
-		displayError(parent, query.lastError(), queryString);
+		displayError(parent, query.lastError(), query.lastQuery());
 	}
+	query.finish();
 }
 
 /**
@@ -805,25 +1049,17 @@ void Table::updateRowInSql(QWidget& parent, const ValidItemID primaryKey, const
 void Table::removeRowFromSql(QWidget& parent, const QList<const Column*>& primaryKeyColumns, const QList<ValidItemID>& primaryKeys)
 {
 	assert(!primaryKeys.isEmpty());
+	assert(primaryKeyColumns.size() == primaryKeys.size());
 	
-	QString condition = "";
+	QSqlQuery& query = getPreparedQuery(parent, RemoveRowQuery, primaryKeyColumns);
 	for (int i = 0; i < primaryKeys.size(); i++) {
-		if (i > 0) condition.append(" AND ");
-		const Column& column = *primaryKeyColumns.at(i);
-		assert(&column.table == this && column.isPrimaryKey());
-		
-		condition.append(column.name + " = " + QString::number(ID_GET(primaryKeys.at(i))));
+		query.bindValue(i, ID_GET(primaryKeys.at(i)));
 	}
-	QString queryString = QString(
-			"DELETE FROM " + name +
-			"\nWHERE " + condition
-	);
-	QSqlQuery query = QSqlQuery();
-	query.setForwardOnly(true);
 	
-	if (!query.exec(queryString)) {
-		displayError(parent, query.lastError(), queryString);
+	if (!query.exec()) {
+		displayError(parent, query.lastError(), query.lastQuery());
 	}
+	query.finish();
 }
 
 /**
@@ -837,33 +1073,127 @@ void Table::removeMatchingRowsFromSql(QWidget& parent, const Column& column, Val
 {
 	assert(getColumnList().contains(&column));
 	
-	QString queryString = QString(
-			"DELETE FROM " + name +
-			"\nWHERE " + column.name + " = " + QString::number(ID_GET(key))
-	);
-	QSqlQuery query = QSqlQuery();
-	query.setForwardOnly(true);
+	QSqlQuery& query = getPreparedQuery(parent, RemoveMatchingRowsQuery, { &column });
+	query.bindValue(0, ID_GET(key));
 	
-	if (!query.exec(queryString)) {
-		displayError(parent, query.lastError(), queryString);
+	if (!query.exec()) {
+		displayError(parent, query.lastError(), query.lastQuery());
 	}
+	query.finish();
 }
 
 
 /**
- * Returns a string listing the given columns' names from a list of column-data pairs.
+ * Extracts the columns from a list of column-data pairs.
  * 
  * @param columnDataPairs	A list of pairs of columns and associated values.
- * @return					A comma-separated list of the columns' names.
+ * @return					The columns of all pairs, in the same order.
  */
-QString Table::getColumnListStringFrom(const QList<ColumnDataPair>& columnDataPairs)
+QList<const Column*> Table::getColumnsFrom(const QList<ColumnDataPair>& columnDataPairs)
 {
-	QString listString = QString();
+	QList<const Column*> columns = QList<const Column*>();
+	columns.reserve(columnDataPairs.size());
 	for (const auto& [column, data] : columnDataPairs) {
-		if (!listString.isEmpty()) listString.append(", ");
-		listString.append(column->name);
+		columns.append(column);
+	}
+	return columns;
+}
+
+/**
+ * Returns a prepared query of the given type for the given columns, preparing it only if it has
+ * not been used before.
+ * 
+ * Since primary keys and values are bound instead of being part of the query string, queries of
+ * the same shape are reused for all rows, and the query string is only assembled when the query
+ * is prepared. Values bound to the returned query are overwritten.
+ * 
+ * @param parent	The parent window.
+ * @param type		The type of the query.
+ * @param columns	The columns the query binds values for, in order (see getPreparedQueryString()).
+ * @return			A prepared query of the given type for the given columns.
+ */
+QSqlQuery& Table::getPreparedQuery(QWidget& parent, PreparedQueryType type, const QList<const Column*>& columns)
+{
+	unique_ptr<QSqlQuery>& query = preparedQueries[PreparedQueryKey(type, columns)];
+	if (!query) {
+		const QString queryString = getPreparedQueryString(type, columns);
+		query = std::make_unique<QSqlQuery>();
+		query->setForwardOnly(true);
+		if (!query->prepare(queryString)) {
+			displayError(parent, query->lastError(), queryString);
+		}
 	}
-	return listString;
+	return *query;
+}
+
+/**
+ * Assembles the query string for a prepared query of the given type for the given columns.
+ * 
+ * For adding rows, the columns are those for which values are inserted. For updating cells or
+ * rows, they are the columns to set, followed by the primary key as the last bound value. For
+ * removing rows, they are the columns which are compared to the bound values.
+ * 
+ * @param type		The type of the query.
+ * @param columns	The columns the query binds values for, in order.
+ * @return			The query string with placeholders for all values.
+ */
+QString Table::getPreparedQueryString(PreparedQueryType type, const QList<const Column*>& columns) const
+{
+	assert(!columns.isEmpty());
+	
+	switch (type) {
+	case AddRowQuery: {
+		QString questionMarks = "";
+		for (int i = 0; i < columns.size(); i++) {
+			questionMarks = questionMarks + ((i == 0) ? "?" : ", ?");
+		}
+		return QString(
+				"INSERT INTO " + name + "(" + getColumnListStringOf(columns) + ")" +
+				"\nVALUES(" + questionMarks + ")"
+		);
+	}
+	case UpdateCellQuery:
+	case UpdateRowQuery: {
+		const Column& primaryKeyColumn = *getPrimaryKeyColumnList().first();
+		QString setString = "";
+		for (const Column* const column : columns) {
+			if (!setString.isEmpty()) setString.append(", ");
+			setString.append(column->name).append(" = ?");
+		}
+		return QString(
+				"UPDATE " + name +
+				"\nSET " + setString +
+				"\nWHERE " + primaryKeyColumn.name + " = ?"
+		);
+	}
+	case RemoveRowQuery:
+	case RemoveMatchingRowsQuery: {
+		QString condition = "";
+		for (const Column* const column : columns) {
+			assert(&column->table == this);
+			assert(type != RemoveRowQuery || column->isPrimaryKey());
+			if (!condition.isEmpty()) condition.append(" AND ");
+			condition.append(column->name + " = ?");
+		}
+		return QString(
+				"DELETE FROM " + name +
+				"\nWHERE " + condition
+		);
+	}
+	default:
+		assert(false);
+		return QString();
+	}
+}
+
+/**
+ * Discards all prepared queries.
+ * 
+ * Has to be called before the database connection is closed.
+ */
+void Table::clearPreparedQueries()
+{
+	preparedQueries.clear();
 }
 
 
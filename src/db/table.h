@@ -29,9 +29,13 @@
 #include "src/db/table_buffer.h"
 
 #include <QAbstractTableModel>
+#include <QHash>
+#include <QSqlQuery>
 #include <QString>
 #include <QWidget>
 
+#include <map>
+
 using std::unique_ptr;
 
 typedef QPair<const Column*, QVariant> ColumnDataPair;
@@ -64,7 +68,26 @@ public:
 protected:
 	/** The buffer for this table. */
 	TableBuffer buffer;
+private:
+	/** Index from primary key to buffer row index, maintained for non-associative tables only. */
+	QHash<ValidItemID, BufferRowIndex> primaryKeyIndex;
+	/** Indices from key to the ascending list of buffer row indices referencing it, one per foreign key column. */
+	QHash<const Column*, QHash<ValidItemID, QList<BufferRowIndex>>> foreignKeyIndices;
 	
+	/** The kinds of statements for modifying this table in the SQL database which are prepared once and reused. */
+	enum PreparedQueryType {
+		AddRowQuery,
+		UpdateCellQuery,
+		UpdateRowQuery,
+		RemoveRowQuery,
+		RemoveMatchingRowsQuery
+	};
+	/** Identifies a prepared statement by its kind and the columns it binds values for, in order. */
+	typedef std::pair<PreparedQueryType, QList<const Column*>> PreparedQueryKey;
+	/** Prepared statements for modifying this table in the SQL database. Only valid as long as the database connection stays open. */
+	std::map<PreparedQueryKey, unique_ptr<QSqlQuery>> preparedQueries;
+	
+protected:
 	Table(Database& db, QString name, QString uiName, bool isAssociative);
 public:
 	virtual ~Table();
@@ -91,9 +114,12 @@ public:
 	void initBuffer(QWidget& parent);
 	void resetBuffer();
 	int getNumberOfRows() const;
-	const QList<QVariant>* getBufferRow(BufferRowIndex bufferRowIndex) const;
+	QList<QVariant> getBufferRow(BufferRowIndex bufferRowIndex) const;
+	QVariant getBufferCell(BufferRowIndex bufferRowIndex, int columnIndex) const;
+	const TableBuffer& getBuffer() const;
 	QList<BufferRowIndex> getMatchingBufferRowIndices(const Column& column, const QVariant& content) const;
 	BufferRowIndex getMatchingBufferRowIndex(const QList<const Column*>& primaryKeyColumns, const QList<ValidItemID>& primaryKeys) const;
+	BufferRowIndex getBufferIndexForPrimaryKey(ValidItemID primaryKey) const;
 	// Debugging
 	void printBuffer() const;
 	
@@ -107,17 +133,33 @@ protected:
 	void removeMatchingRows(QWidget& parent, const Column& column, const QSet<ValidItemID>& keys);
 	void removeMatchingRows(QWidget& parent, const Column& column, ValidItemID key);
 	
+	// Additional buffer indices (implemented in subclasses)
+	virtual void rebuildAdditionalIndices();
+	virtual void addRowToAdditionalIndices(BufferRowIndex bufferRowIndex);
+	virtual void removeRowFromAdditionalIndices(BufferRowIndex bufferRowIndex);
+	
 private:
+	// Buffer modifications
+	void appendBufferRow(const QList<QVariant>& newRow);
+	void removeBufferRow(BufferRowIndex bufferRowIndex);
+	void replaceBufferCell(BufferRowIndex bufferRowIndex, const Column& column, const QVariant& newValue);
+	void rebuildIndices();
+	
+
 	// SQL
 	void createTableInSql(QWidget& parent);
+	bool createForeignKeyIndicesInSql();
 	void addColumnInSql(QWidget& parent, const Column& column);
-	QList<QList<QVariant>*> getAllEntriesFromSql(QWidget& parent) const;
+	QList<QList<QVariant>> getAllEntriesFromSql(QWidget& parent) const;
 	ValidItemID addRowToSql(QWidget& parent, const QList<ColumnDataPair>& columnDataPairs);
 	void updateCellOfNormalTableInSql(QWidget& parent, const ValidItemID primaryKey, const Column& column, const QVariant& data);
 	void updateRowInSql(QWidget& parent, const ValidItemID primaryKey, const QList<ColumnDataPair>& columnDataPairs);
 	void removeRowFromSql(QWidget& parent, const QList<const Column*>& primaryKeyColumns, const QList<ValidItemID>& primaryKeys);
 	void removeMatchingRowsFromSql(QWidget& parent, const Column& column, ValidItemID key);
-	QString getColumnListStringFrom(const QList<ColumnDataPair>& columnDataPairs);
+	static QList<const Column*> getColumnsFrom(const QList<ColumnDataPair>& columnDataPairs);
+	QSqlQuery& getPreparedQuery(QWidget& parent, PreparedQueryType type, const QList<const Column*>& columns);
+	QString getPreparedQueryString(PreparedQueryType type, const QList<const Column*>& columns) const;
+	void clearPreparedQueries();
 	
 public:
 	// QAbstractItemModel implementation (multiData implemented in subclasses)
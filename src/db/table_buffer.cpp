@@ -23,23 +23,29 @@
 
 #include "table_buffer.h"
 
+#include <QDate>
+#include <QTime>
+#include <QtAlgorithms>
+
+#include <numeric>
+
 
 
 /**
  * Creates an empty TableBuffer.
  */
 TableBuffer::TableBuffer() :
-	numColumns(0),
-	buffer(QList<QList<QVariant>*>())
+	rowCount(0),
+	bufferColumns(QList<BufferColumn>()),
+	stringArena(QString()),
+	stringArenaGarbage(0)
 {}
 
 /**
  * Destroys the TableBuffer.
  */
 TableBuffer::~TableBuffer()
-{
-	qDeleteAll(buffer);
-}
+{}
 
 
 /**
@@ -47,24 +53,46 @@ TableBuffer::~TableBuffer()
  */
 void TableBuffer::reset()
 {
-	numColumns = 0;
-	qDeleteAll(buffer);
-	buffer.clear();
+	rowCount = 0;
+	bufferColumns.clear();
+	stringArena.clear();
+	stringArenaGarbage = 0;
 }
 
 /**
- * Sets the initial number of columns for the buffer.
+ * Sets the initial number of columns for the buffer, using generic storage for all of them.
  * 
- * This method should only be called once, before any rows are added to the buffer.
+ * This method or setInitialColumnTypes() should only be called once, before any rows are added
+ * to the buffer.
  * 
  * @param initialNumColumns	The initial number of columns for the buffer.
  */
 void TableBuffer::setInitialNumberOfColumns(int initialNumColumns)
 {
-	assert(numColumns < 1);
-	assert(buffer.isEmpty());
+	assert(bufferColumns.isEmpty());
+	assert(rowCount == 0);
+	
+	for (int i = 0; i < initialNumColumns; i++) {
+		bufferColumns.append(createColumn(GenericStorage, 0));
+	}
+}
+
+/**
+ * Sets the initial columns for the buffer, using typed storage according to the given data types.
+ * 
+ * This method or setInitialNumberOfColumns() should only be called once, before any rows are
+ * added to the buffer.
+ * 
+ * @param columnTypes	The data types of the columns, in order.
+ */
+void TableBuffer::setInitialColumnTypes(const QList<DataType>& columnTypes)
+{
+	assert(bufferColumns.isEmpty());
+	assert(rowCount == 0);
 	
-	numColumns = initialNumColumns;
+	for (const DataType type : columnTypes) {
+		bufferColumns.append(createColumn(getStorageFor(type), 0));
+	}
 }
 
 
@@ -76,7 +104,7 @@ void TableBuffer::setInitialNumberOfColumns(int initialNumColumns)
  */
 int TableBuffer::numRows() const
 {
-	return buffer.size();
+	return rowCount;
 }
 
 /**
@@ -86,21 +114,26 @@ int TableBuffer::numRows() const
  */
 bool TableBuffer::isEmpty() const
 {
-	return buffer.isEmpty();
+	return rowCount == 0;
 }
 
 
 /**
- * Returns the row at the given index.
+ * Assembles the row at the given index.
  * 
  * @param rowIndex	The index of the row to return.
- * @return			The row at the given index.
+ * @return			A copy of the row at the given index.
  */
-const QList<QVariant>* TableBuffer::getRow(BufferRowIndex rowIndex) const
+QList<QVariant> TableBuffer::getRow(BufferRowIndex rowIndex) const
 {
 	assert(rowIndex.isValid(numRows()));
 	
-	return buffer.at(rowIndex.get());
+	QList<QVariant> row = QList<QVariant>();
+	row.reserve(bufferColumns.size());
+	for (const BufferColumn& column : bufferColumns) {
+		row.append(readCell(column, rowIndex.get()));
+	}
+	return row;
 }
 
 /**
@@ -112,10 +145,167 @@ const QList<QVariant>* TableBuffer::getRow(BufferRowIndex rowIndex) const
  */
 QVariant TableBuffer::getCell(BufferRowIndex rowIndex, int columnIndex) const
 {
-	assert(columnIndex >= 0 && columnIndex < numColumns);
+	assert(rowIndex.isValid(numRows()));
+	assert(columnIndex >= 0 && columnIndex < bufferColumns.size());
+	
+	return readCell(bufferColumns.at(columnIndex), rowIndex.get());
+}
+
+/**
+ * Provides direct read access to a column whose cells are stored as integers in the representation
+ * used for the given type, following shared columns to their source.
+ * 
+ * This applies to integers, IDs, enums and dual enums, as well as dates (as day numbers) and times
+ * (as milliseconds since midnight). Empty cells are flagged in the null flags.
+ * 
+ * @param columnIndex	The index of the column.
+ * @param type			The data type whose integer representation is expected.
+ * @param values		Set to the integer values of all cells in the column, if applicable.
+ * @param nullFlags		Set to the flags marking empty cells in the column, if applicable.
+ * @return				True if the column is stored as integers for the given type, false otherwise.
+ */
+bool TableBuffer::getIntegerColumn(int columnIndex, DataType type, const QList<qint32>*& values, const std::vector<bool>*& nullFlags) const
+{
+	assert(columnIndex >= 0 && columnIndex < bufferColumns.size());
+	
+	const BufferColumn& column = bufferColumns.at(columnIndex);
+	if (column.storage == SharedStorage) {
+		return column.sourceBuffer->getIntegerColumn(column.sourceColumnIndex, type, values, nullFlags);
+	}
+	
+	const bool integerType = type == Integer || type == ID || type == Enum || type == DualEnum || type == Date || type == Time;
+	if (!integerType || column.storage != getStorageFor(type)) return false;
+	
+	values		= &column.values;
+	nullFlags	= &column.bits;
+	return true;
+}
+
+/**
+ * Provides direct read access to a column whose cells are stored as packed bits, following shared
+ * columns to their source.
+ * 
+ * Bit columns have no empty cells.
+ * 
+ * @param columnIndex	The index of the column.
+ * @param bits			Set to the values of all cells in the column, if applicable.
+ * @return				True if the column is stored as bits, false otherwise.
+ */
+bool TableBuffer::getBitColumn(int columnIndex, const std::vector<bool>*& bits) const
+{
+	assert(columnIndex >= 0 && columnIndex < bufferColumns.size());
+	
+	const BufferColumn& column = bufferColumns.at(columnIndex);
+	if (column.storage == SharedStorage) {
+		return column.sourceBuffer->getBitColumn(column.sourceColumnIndex, bits);
+	}
+	
+	if (column.storage != BitStorage) return false;
+	
+	bits = &column.bits;
+	return true;
+}
+
+/**
+ * Provides direct read access to a column whose cells are stored in the string arena, following
+ * shared columns to their source.
+ * 
+ * The string in a cell is the segment of the arena with the cell's offset and length. Empty cells
+ * are flagged in the null flags. The pointers are only valid until the next write to the buffer
+ * owning the column.
+ * 
+ * @param columnIndex	The index of the column.
+ * @param arena			Set to the string arena containing the cells of the column, if applicable.
+ * @param offsets		Set to the offsets of all cells in the string arena, if applicable.
+ * @param lengths		Set to the lengths of all cells in the string arena, if applicable.
+ * @param nullFlags		Set to the flags marking empty cells in the column, if applicable.
+ * @return				True if the column is stored as strings, false otherwise.
+ */
+bool TableBuffer::getStringColumn(int columnIndex, const QString*& arena, const QList<qint32>*& offsets, const QList<qint32>*& lengths, const std::vector<bool>*& nullFlags) const
+{
+	assert(columnIndex >= 0 && columnIndex < bufferColumns.size());
+	
+	const BufferColumn& column = bufferColumns.at(columnIndex);
+	if (column.storage == SharedStorage) {
+		return column.sourceBuffer->getStringColumn(column.sourceColumnIndex, arena, offsets, lengths, nullFlags);
+	}
+	
+	if (column.storage != StringStorage) return false;
+	
+	arena		= &stringArena;
+	offsets		= &column.values;
+	lengths		= &column.stringLengths;
+	nullFlags	= &column.bits;
+	return true;
+}
+
+/**
+ * Returns the cached formatted value of the cell at the given index, if any.
+ * 
+ * @param rowIndex		The row index of the cell.
+ * @param columnIndex	The column index of the cell.
+ * @return				The cached formatted value of the cell, or an invalid QVariant if there is none.
+ */
+QVariant TableBuffer::getCachedFormattedCell(BufferRowIndex rowIndex, int columnIndex) const
+{
+	assert(rowIndex.isValid(rowCount));
+	assert(columnIndex >= 0 && columnIndex < bufferColumns.size());
+	
+	const BufferColumn& column = bufferColumns.at(columnIndex);
+	if (column.formattedVariants.isEmpty()) return QVariant();
+	return column.formattedVariants.at(rowIndex.get());
+}
+
+/**
+ * Caches the formatted value of the cell at the given index until the cell changes.
+ * 
+ * This does not change the contents of the buffer. Only cells of generic and shared columns are
+ * cached. For shared columns, the cached cells have to be discarded by the caller whenever the
+ * cells change in the source buffer (see discardFormattedCell() and discardFormattedColumn()).
+ * 
+ * @param rowIndex			The row index of the cell.
+ * @param columnIndex		The column index of the cell.
+ * @param formattedValue	The formatted value of the cell's current content.
+ */
+void TableBuffer::cacheFormattedCell(BufferRowIndex rowIndex, int columnIndex, const QVariant& formattedValue) const
+{
+	assert(rowIndex.isValid(rowCount));
+	assert(columnIndex >= 0 && columnIndex < bufferColumns.size());
+	
+	const BufferColumn& column = bufferColumns.at(columnIndex);
+	if (column.storage != GenericStorage && column.storage != SharedStorage) return;
+	if (column.formattedVariants.isEmpty()) {
+		column.formattedVariants = QList<QVariant>(rowCount, QVariant());
+	}
+	column.formattedVariants.replace(rowIndex.get(), formattedValue);
+}
+
+/**
+ * Discards the cached formatted value of the cell at the given index, if any.
+ * 
+ * @param rowIndex		The row index of the cell.
+ * @param columnIndex	The column index of the cell.
+ */
+void TableBuffer::discardFormattedCell(BufferRowIndex rowIndex, int columnIndex)
+{
+	assert(rowIndex.isValid(rowCount));
+	assert(columnIndex >= 0 && columnIndex < bufferColumns.size());
+	
+	BufferColumn& column = bufferColumns[columnIndex];
+	if (column.formattedVariants.isEmpty()) return;
+	column.formattedVariants.replace(rowIndex.get(), QVariant());
+}
+
+/**
+ * Discards the cached formatted values of all cells in the column at the given index.
+ * 
+ * @param columnIndex	The index of the column.
+ */
+void TableBuffer::discardFormattedColumn(int columnIndex)
+{
+	assert(columnIndex >= 0 && columnIndex < bufferColumns.size());
 	
-	const QList<QVariant>* row = getRow(rowIndex);
-	return row->at(columnIndex);
+	bufferColumns[columnIndex].formattedVariants.clear();
 }
 
 
@@ -124,11 +314,9 @@ QVariant TableBuffer::getCell(BufferRowIndex rowIndex, int columnIndex) const
  * 
  * @param newRow	The row to append.
  */
-void TableBuffer::appendRow(QList<QVariant>* newRow)
+void TableBuffer::appendRow(const QList<QVariant>& newRow)
 {
-	assert(newRow->size() == numColumns);
-	
-	buffer.append(newRow);
+	insertRow(BufferRowIndex(rowCount), newRow);
 }
 
 /**
@@ -137,12 +325,41 @@ void TableBuffer::appendRow(QList<QVariant>* newRow)
  * @param rowIndex	The index at which to insert the new row.
  * @param newRow	The row to insert.
  */
-void TableBuffer::insertRow(BufferRowIndex rowIndex, QList<QVariant>* newRow)
+void TableBuffer::insertRow(BufferRowIndex rowIndex, const QList<QVariant>& newRow)
 {
-	assert(rowIndex.isValid(buffer.size() + 1));
-	assert(newRow->size() == numColumns);
+	assert(rowIndex.isValid(rowCount + 1));
+	assert(newRow.size() == bufferColumns.size());
 	
-	buffer.insert(rowIndex.get(), newRow);
+	const int row = rowIndex.get();
+	for (int columnIndex = 0; columnIndex < bufferColumns.size(); columnIndex++) {
+		BufferColumn& column = bufferColumns[columnIndex];
+		switch (column.storage) {
+		case GenericStorage:
+			column.variants.insert(row, QVariant());
+			if (!column.formattedVariants.isEmpty()) column.formattedVariants.insert(row, QVariant());
+			break;
+		case StringStorage:
+			column.stringLengths.insert(row, 0);
+			// fallthrough
+		case IntStorage:
+		case DateStorage:
+		case TimeStorage:
+			column.values.insert(row, 0);
+			// Null flag
+			column.bits.insert(column.bits.begin() + row, true);
+			break;
+		case BitStorage:
+			column.bits.insert(column.bits.begin() + row, false);
+			break;
+		case SharedStorage:
+			// Cells are stored in the source buffer
+			if (!column.formattedVariants.isEmpty()) column.formattedVariants.insert(row, QVariant());
+			continue;
+		default: assert(false);
+		}
+		writeCell(column, row, newRow.at(columnIndex));
+	}
+	rowCount++;
 }
 
 /**
@@ -152,11 +369,36 @@ void TableBuffer::insertRow(BufferRowIndex rowIndex, QList<QVariant>* newRow)
  */
 void TableBuffer::removeRow(BufferRowIndex rowIndex)
 {
-	assert(rowIndex.isValid(buffer.size()));
+	assert(rowIndex.isValid(rowCount));
+	
+	const int row = rowIndex.get();
+	for (BufferColumn& column : bufferColumns) {
+		switch (column.storage) {
+		case GenericStorage:
+			column.variants.remove(row);
+			if (!column.formattedVariants.isEmpty()) column.formattedVariants.remove(row);
+			break;
+		case StringStorage:
+			releaseString(column, row);
+			column.stringLengths.remove(row);
+			// fallthrough
+		case IntStorage:
+		case DateStorage:
+		case TimeStorage:
+			column.values.remove(row);
+			// fallthrough
+		case BitStorage:
+			column.bits.erase(column.bits.begin() + row);
+			break;
+		case SharedStorage:
+			if (!column.formattedVariants.isEmpty()) column.formattedVariants.remove(row);
+			break;
+		default: assert(false);
+		}
+	}
+	rowCount--;
 	
-	const QList<QVariant>* rowToRemove = buffer.at(rowIndex.get());
-	buffer.remove(rowIndex.get());
-	delete rowToRemove;
+	compactStringArenaIfWorthwhile();
 }
 
 /**
@@ -168,24 +410,51 @@ void TableBuffer::removeRow(BufferRowIndex rowIndex)
  */
 void TableBuffer::replaceCell(BufferRowIndex rowIndex, int columnIndex, const QVariant& newValue)
 {
-	assert(rowIndex.isValid(buffer.size()));
-	assert(columnIndex >= 0 && columnIndex < numColumns);
+	assert(rowIndex.isValid(rowCount));
+	assert(columnIndex >= 0 && columnIndex < bufferColumns.size());
+	
+	writeCell(bufferColumns[columnIndex], rowIndex.get(), newValue);
 	
-	QList<QVariant>* row = buffer.at(rowIndex.get());
-	row->replace(columnIndex, newValue);
+	compactStringArenaIfWorthwhile();
 }
 
 
 /**
- * Appends space for a new column to the buffer.
+ * Appends space for a new column with generic storage to the buffer.
  */
 void TableBuffer::appendColumn()
 {
-	for (QList<QVariant>* const row : std::as_const(buffer)) {
-		row->append(QVariant());
+	bufferColumns.append(createColumn(GenericStorage, rowCount));
+}
+
+/**
+ * Replaces the column at the given index with a column whose cells are read from a column in
+ * another buffer, discarding its current contents.
+ * 
+ * Shared columns cannot be written to. The source buffer must contain the same rows as this buffer
+ * whenever cells of the shared column are read.
+ * 
+ * @param columnIndex		The index of the column to replace.
+ * @param sourceBuffer		The buffer containing the cells of the column.
+ * @param sourceColumnIndex	The index of the column in the source buffer.
+ */
+void TableBuffer::shareColumn(int columnIndex, const TableBuffer& sourceBuffer, int sourceColumnIndex)
+{
+	assert(columnIndex >= 0 && columnIndex < bufferColumns.size());
+	assert(&sourceBuffer != this);
+	assert(sourceColumnIndex >= 0 && sourceColumnIndex < sourceBuffer.bufferColumns.size());
+	
+	BufferColumn& column = bufferColumns[columnIndex];
+	if (column.storage == StringStorage) {
+		for (int row = 0; row < rowCount; row++) {
+			releaseString(column, row);
+		}
 	}
+	column = createColumn(SharedStorage, 0);
+	column.sourceBuffer = &sourceBuffer;
+	column.sourceColumnIndex = sourceColumnIndex;
 	
-	numColumns++;
+	compactStringArenaIfWorthwhile();
 }
 
 /**
@@ -195,35 +464,301 @@ void TableBuffer::appendColumn()
  */
 void TableBuffer::removeColumn(int columnIndex)
 {
-	assert(columnIndex >= 0 && columnIndex < numColumns);
+	assert(columnIndex >= 0 && columnIndex < bufferColumns.size());
+	
+	const BufferColumn& column = bufferColumns.at(columnIndex);
+	if (column.storage == StringStorage) {
+		for (int row = 0; row < rowCount; row++) {
+			releaseString(column, row);
+		}
+	}
+	bufferColumns.remove(columnIndex);
 	
-	for (QList<QVariant>* const row : std::as_const(buffer)) {
-		row->remove(columnIndex);
+	compactStringArenaIfWorthwhile();
+}
+
+
+
+/**
+ * Determines how cells of a column with the given data type are stored.
+ * 
+ * @param type	The data type of the column.
+ * @return		The storage type to use for the column.
+ */
+TableBuffer::ColumnStorage TableBuffer::getStorageFor(DataType type)
+{
+	switch (type) {
+	case Integer:
+	case ID:
+	case Enum:
+	case DualEnum:	return IntStorage;
+	case Bit:		return BitStorage;
+	case Date:		return DateStorage;
+	case Time:		return TimeStorage;
+	case String:	return StringStorage;
+	default: assert(false);
+	}
+	return GenericStorage;
+}
+
+/**
+ * Creates a column with the given storage type, filled with the given number of empty cells.
+ * 
+ * @param storage	The storage type of the new column.
+ * @param numRows	The number of empty cells to fill the column with.
+ * @return			The new column.
+ */
+TableBuffer::BufferColumn TableBuffer::createColumn(ColumnStorage storage, int numRows)
+{
+	BufferColumn column = BufferColumn();
+	column.storage = storage;
+	column.sourceBuffer = nullptr;
+	column.sourceColumnIndex = -1;
+	switch (storage) {
+	case GenericStorage:
+		column.variants = QList<QVariant>(numRows, QVariant());
+		break;
+	case StringStorage:
+		column.stringLengths = QList<qint32>(numRows, 0);
+		// fallthrough
+	case IntStorage:
+	case DateStorage:
+	case TimeStorage:
+		column.values = QList<qint32>(numRows, 0);
+		column.bits = std::vector<bool>(numRows, true);
+		break;
+	case BitStorage:
+		column.bits = std::vector<bool>(numRows, false);
+		break;
+	case SharedStorage:
+		break;
+	default: assert(false);
+	}
+	return column;
+}
+
+
+/**
+ * Reads the value of a single cell.
+ * 
+ * Empty dates and times are returned as invalid QDate and QTime objects, all other empty cells as
+ * invalid QVariants.
+ * 
+ * @param column	The column containing the cell.
+ * @param rowIndex	The row index of the cell.
+ * @return			The value of the cell.
+ */
+QVariant TableBuffer::readCell(const BufferColumn& column, int rowIndex) const
+{
+	switch (column.storage) {
+	case GenericStorage:
+		return column.variants.at(rowIndex);
+	case IntStorage:
+		if (column.bits[rowIndex]) return QVariant();
+		return QVariant(column.values.at(rowIndex));
+	case BitStorage:
+		return QVariant((bool) column.bits[rowIndex]);
+	case DateStorage:
+		if (column.bits[rowIndex]) return QVariant(QDate());
+		return QVariant(QDate::fromJulianDay(column.values.at(rowIndex)));
+	case TimeStorage:
+		if (column.bits[rowIndex]) return QVariant(QTime());
+		return QVariant(QTime::fromMSecsSinceStartOfDay(column.values.at(rowIndex)));
+	case StringStorage:
+		if (column.bits[rowIndex]) return QVariant();
+		return QVariant(stringArena.mid(column.values.at(rowIndex), column.stringLengths.at(rowIndex)));
+	case SharedStorage:
+		return column.sourceBuffer->getCell(BufferRowIndex(rowIndex), column.sourceColumnIndex);
+	default: assert(false);
+	}
+	return QVariant();
+}
+
+/**
+ * Writes the given value into an existing cell.
+ * 
+ * @param column	The column containing the cell.
+ * @param rowIndex	The row index of the cell.
+ * @param newValue	The new value for the cell.
+ */
+void TableBuffer::writeCell(BufferColumn& column, int rowIndex, const QVariant& newValue)
+{
+	switch (column.storage) {
+	case GenericStorage: {
+		column.variants.replace(rowIndex, newValue);
+		if (!column.formattedVariants.isEmpty()) column.formattedVariants.replace(rowIndex, QVariant());
+		break;
 	}
+	case IntStorage: {
+		const bool isNull = !newValue.isValid() || newValue.isNull();
+		column.values.replace(rowIndex, isNull ? 0 : newValue.toInt());
+		column.bits[rowIndex] = isNull;
+		break;
+	}
+	case BitStorage: {
+		column.bits[rowIndex] = newValue.toBool();
+		break;
+	}
+	case DateStorage: {
+		const QDate date = newValue.toDate();
+		const bool isNull = !date.isValid();
+		column.values.replace(rowIndex, isNull ? 0 : (qint32) date.toJulianDay());
+		column.bits[rowIndex] = isNull;
+		break;
+	}
+	case TimeStorage: {
+		const QTime time = newValue.toTime();
+		const bool isNull = !time.isValid();
+		column.values.replace(rowIndex, isNull ? 0 : time.msecsSinceStartOfDay());
+		column.bits[rowIndex] = isNull;
+		break;
+	}
+	case StringStorage: {
+		releaseString(column, rowIndex);
+		const bool isNull = !newValue.isValid() || newValue.isNull();
+		if (isNull) {
+			column.values.replace(rowIndex, 0);
+			column.stringLengths.replace(rowIndex, 0);
+		} else {
+			const QString string = newValue.toString();
+			column.values.replace(rowIndex, (qint32) stringArena.size());
+			column.stringLengths.replace(rowIndex, (qint32) string.size());
+			stringArena.append(string);
+		}
+		column.bits[rowIndex] = isNull;
+		break;
+	}
+	default: assert(false);
+	}
+}
+
+/**
+ * Marks the segment of the string arena used by the given string cell as garbage.
+ * 
+ * @param column	The string column containing the cell.
+ * @param rowIndex	The row index of the cell.
+ */
+void TableBuffer::releaseString(const BufferColumn& column, int rowIndex)
+{
+	assert(column.storage == StringStorage);
+	
+	if (column.bits[rowIndex]) return;
+	stringArenaGarbage += column.stringLengths.at(rowIndex);
+}
+
+/**
+ * Rebuilds the string arena without unused segments if they make up more than half of it.
+ */
+void TableBuffer::compactStringArenaIfWorthwhile()
+{
+	if (stringArenaGarbage < 4096 || stringArenaGarbage * 2 < stringArena.size()) return;
 	
-	numColumns--;
+	QString newArena = QString();
+	newArena.reserve(stringArena.size() - stringArenaGarbage);
+	for (BufferColumn& column : bufferColumns) {
+		if (column.storage != StringStorage) continue;
+		
+		for (int row = 0; row < rowCount; row++) {
+			if (column.bits[row]) continue;
+			const qint32 length = column.stringLengths.at(row);
+			const qint32 newOffset = (qint32) newArena.size();
+			newArena.append(QStringView(stringArena).mid(column.values.at(row), length));
+			column.values.replace(row, newOffset);
+		}
+	}
+	stringArena = newArena;
+	stringArenaGarbage = 0;
 }
 
 
 
+
+
 /**
- * Returns an iterator pointing to the first row in the buffer.
+ * Creates a BufferRowSelection for the given number of buffer rows.
  * 
- * @return An iterator pointing to the first row in the buffer.
+ * @param numBufferRows	The number of rows in the buffer.
+ * @param selectAll		Whether all rows should initially be selected, as opposed to none.
  */
-QList<QList<QVariant>*>::const_iterator TableBuffer::begin() const
+BufferRowSelection::BufferRowSelection(int numBufferRows, bool selectAll) :
+	numBufferRows(numBufferRows),
+	words(QList<quint64>((numBufferRows + 63) / 64, selectAll ? ~(quint64) 0 : 0))
 {
-	return buffer.begin();
+	assert(numBufferRows >= 0);
+	// Keep unused bits in the last word cleared
+	const int numUsedBitsInLastWord = numBufferRows % 64;
+	if (selectAll && numUsedBitsInLastWord > 0) {
+		words.last() &= ((quint64) 1 << numUsedBitsInLastWord) - 1;
+	}
 }
 
+
 /**
- * Returns an iterator pointing to the row after the last row in the buffer.
+ * Returns the number of rows in the buffer, selected or not.
  * 
- * @return An iterator pointing to the row after the last row in the buffer.
+ * @return	The number of rows in the buffer.
  */
-QList<QList<QVariant>*>::const_iterator TableBuffer::end() const
+int BufferRowSelection::size() const
 {
-	return buffer.end();
+	return numBufferRows;
+}
+
+/**
+ * Indicates whether the given row is selected.
+ * 
+ * @param rowIndex	The buffer row index to check.
+ * @return			True if the row is selected, false otherwise.
+ */
+bool BufferRowSelection::contains(BufferRowIndex rowIndex) const
+{
+	assert(rowIndex.isValid(numBufferRows));
+	return words.at(rowIndex.get() / 64) & ((quint64) 1 << (rowIndex.get() % 64));
+}
+
+/**
+ * Returns the indices of all selected rows in ascending order.
+ * 
+ * Words without any selected rows are skipped as a whole, so this is fast for sparse selections.
+ * 
+ * @return	The buffer row indices of all selected rows.
+ */
+QList<BufferRowIndex> BufferRowSelection::getSelectedRows() const
+{
+	QList<BufferRowIndex> result = QList<BufferRowIndex>();
+	for (int wordIndex = 0; wordIndex < words.size(); wordIndex++) {
+		quint64 word = words.at(wordIndex);
+		while (word) {
+			const int bit = qCountTrailingZeroBits(word);
+			result.append(BufferRowIndex(wordIndex * 64 + bit));
+			word &= word - 1;
+		}
+	}
+	return result;
+}
+
+
+/**
+ * Adds the given row to the selection.
+ * 
+ * @param rowIndex	The buffer row index to select.
+ */
+void BufferRowSelection::select(BufferRowIndex rowIndex)
+{
+	assert(rowIndex.isValid(numBufferRows));
+	words[rowIndex.get() / 64] |= (quint64) 1 << (rowIndex.get() % 64);
+}
+
+/**
+ * Removes all rows from the selection which are not selected in the given selection.
+ * 
+ * @param other	The selection to intersect with, for the same number of buffer rows.
+ */
+void BufferRowSelection::intersect(const BufferRowSelection& other)
+{
+	assert(other.numBufferRows == numBufferRows);
+	for (int i = 0; i < words.size(); i++) {
+		words[i] &= other.words.at(i);
+	}
 }
 
 
@@ -234,7 +769,8 @@ QList<QList<QVariant>*>::const_iterator TableBuffer::end() const
  * Creates an empty ViewOrderBuffer.
  */
 ViewOrderBuffer::ViewOrderBuffer() :
-	order(QList<BufferRowIndex>())
+	order(QList<BufferRowIndex>()),
+	viewRowsByBufferRow(QList<int>())
 {}
 
 
@@ -244,6 +780,7 @@ ViewOrderBuffer::ViewOrderBuffer() :
 void ViewOrderBuffer::clear()
 {
 	order.clear();
+	viewRowsByBufferRow.clear();
 }
 
 
@@ -268,6 +805,16 @@ bool ViewOrderBuffer::isEmpty() const
 }
 
 
+/**
+ * Returns all buffer row indices in the order buffer, in view order.
+ * 
+ * @return	The buffer row indices in the order buffer.
+ */
+const QList<BufferRowIndex>& ViewOrderBuffer::getBufferRowIndices() const
+{
+	return order;
+}
+
 /**
  * Returns the buffer row index of the item at the given row in the view.
  * 
@@ -284,15 +831,15 @@ BufferRowIndex ViewOrderBuffer::getBufferRowIndexForViewRow(ViewRowIndex viewRow
  * Determines at which row of the view the given buffer row index is stored, if any.
  * 
  * If the given buffer row index is not stored in the order buffer, returns an invalid
- * ViewRowIndex.
+ * ViewRowIndex. Takes constant time, since the inverse of the order buffer is kept up to date.
  * 
  * @param bufferRowIndex	The index of the buffer row to look up.
  * @return					The view row index where the given buffer row index is stored, if any.
  */
 ViewRowIndex ViewOrderBuffer::findViewRowIndexForBufferRow(BufferRowIndex bufferRowIndex) const
 {
-	if (Q_UNLIKELY(bufferRowIndex.isInvalid())) return ViewRowIndex();
-	return ViewRowIndex(order.indexOf(bufferRowIndex));
+	if (Q_UNLIKELY(bufferRowIndex.isInvalid(viewRowsByBufferRow.size()))) return ViewRowIndex();
+	return ViewRowIndex(viewRowsByBufferRow.at(bufferRowIndex.get()));
 }
 
 
@@ -303,17 +850,82 @@ ViewRowIndex ViewOrderBuffer::findViewRowIndexForBufferRow(BufferRowIndex buffer
  */
 void ViewOrderBuffer::append(BufferRowIndex rowIndex)
 {
+	setViewRowFor(rowIndex, order.size());
 	order.append(rowIndex);
 }
 
 /**
  * Inserts the given buffer row index into the order buffer at the given view row index.
  * 
+ * @param viewRowIndex	The view row index at which to insert the buffer row index.
+ * @param rowIndex		The buffer row index to insert.
+ */
+void ViewOrderBuffer::insert(ViewRowIndex viewRowIndex, BufferRowIndex rowIndex)
+{
+	order.insert(viewRowIndex.get(), rowIndex);
+	updateViewRows(viewRowIndex.get(), order.size() - 1);
+}
+
+/**
+ * Removes the buffer row index at the given view row index from the order buffer.
+ * 
  * @param viewRowIndex	The view row index at which to remove the buffer row index.
  */
 void ViewOrderBuffer::removeViewRow(ViewRowIndex viewRowIndex)
 {
+	setViewRowFor(order.at(viewRowIndex.get()), -1);
 	order.removeAt(viewRowIndex.get());
+	updateViewRows(viewRowIndex.get(), order.size() - 1);
+}
+
+/**
+ * Moves the buffer row index at the given view row index to another view row index.
+ * 
+ * @param fromViewRowIndex	The view row index of the buffer row index to move.
+ * @param toViewRowIndex	The view row index at which the buffer row index should be after the move.
+ */
+void ViewOrderBuffer::moveViewRow(ViewRowIndex fromViewRowIndex, ViewRowIndex toViewRowIndex)
+{
+	order.move(fromViewRowIndex.get(), toViewRowIndex.get());
+	updateViewRows(std::min(fromViewRowIndex.get(), toViewRowIndex.get()), std::max(fromViewRowIndex.get(), toViewRowIndex.get()));
+}
+
+/**
+ * Adjusts all stored buffer row indices after a row was inserted into the buffer, so that they
+ * keep referring to the same rows.
+ * 
+ * The inserted row itself is not added to the order buffer.
+ * 
+ * @param insertedRowIndex	The buffer row index at which a row was inserted.
+ */
+void ViewOrderBuffer::adjustForInsertedBufferRow(BufferRowIndex insertedRowIndex)
+{
+	for (BufferRowIndex& rowIndex : order) {
+		if (rowIndex >= insertedRowIndex) rowIndex++;
+	}
+	if (insertedRowIndex.get() < viewRowsByBufferRow.size()) {
+		viewRowsByBufferRow.insert(insertedRowIndex.get(), -1);
+	}
+}
+
+/**
+ * Adjusts all stored buffer row indices after a row was removed from the buffer, so that they
+ * keep referring to the same rows.
+ * 
+ * @pre The removed row is not in the order buffer anymore.
+ * 
+ * @param removedRowIndex	The buffer row index at which a row was removed.
+ */
+void ViewOrderBuffer::adjustForRemovedBufferRow(BufferRowIndex removedRowIndex)
+{
+	for (BufferRowIndex& rowIndex : order) {
+		assert(!(rowIndex == removedRowIndex));
+		if (rowIndex > removedRowIndex) rowIndex--;
+	}
+	if (removedRowIndex.get() < viewRowsByBufferRow.size()) {
+		assert(viewRowsByBufferRow.at(removedRowIndex.get()) == -1);
+		viewRowsByBufferRow.removeAt(removedRowIndex.get());
+	}
 }
 
 /**
@@ -324,7 +936,39 @@ void ViewOrderBuffer::removeViewRow(ViewRowIndex viewRowIndex)
  */
 void ViewOrderBuffer::replaceBufferRowIndexAtViewRowIndex(ViewRowIndex viewRowIndex, BufferRowIndex newBufferRowIndex)
 {
+	setViewRowFor(order.at(viewRowIndex.get()), -1);
 	order.replace(viewRowIndex.get(), newBufferRowIndex);
+	setViewRowFor(newBufferRowIndex, viewRowIndex.get());
+}
+
+
+/**
+ * Returns the set of all buffer rows which are currently in the order buffer.
+ * 
+ * @param numBufferRows	The number of rows in the buffer.
+ * @return				A selection of all buffer rows in the order buffer.
+ */
+BufferRowSelection ViewOrderBuffer::getSelection(int numBufferRows) const
+{
+	BufferRowSelection selection = BufferRowSelection(numBufferRows, false);
+	for (const BufferRowIndex& bufferRowIndex : order) {
+		selection.select(bufferRowIndex);
+	}
+	return selection;
+}
+
+/**
+ * Removes all rows which are not in the given selection from the order buffer in a single pass,
+ * keeping the order of the remaining rows.
+ * 
+ * @param selection	The selection of buffer rows to keep.
+ */
+void ViewOrderBuffer::retainSelected(const BufferRowSelection& selection)
+{
+	order.removeIf([&selection] (const BufferRowIndex& bufferRowIndex) {
+		return !selection.contains(bufferRowIndex);
+	});
+	rebuildViewRows();
 }
 
 
@@ -334,14 +978,84 @@ void ViewOrderBuffer::replaceBufferRowIndexAtViewRowIndex(ViewRowIndex viewRowIn
 void ViewOrderBuffer::reverse()
 {
 	std::reverse(order.begin(), order.end());
+	updateViewRows(0, order.size() - 1);
 }
 
 /**
- * Sorts the buffer according to the given comparator applied to the buffer row indices.
+ * Sorts the buffer by the given precomputed sort keys, using the keys of each further pass to
+ * break ties in the previous ones.
  * 
- * @param comparator	The comparator to use for sorting.
+ * Only a permutation of view row positions is sorted, comparing plain integers, and the buffer is
+ * rearranged once at the end. The sort is stable, so rows with equal keys keep their relative order.
+ * 
+ * @param sortKeys		For each sorting pass, the sort key for each view row in current view order.
+ * @param sortOrders	For each sorting pass, whether to sort in ascending or descending order.
+ */
+void ViewOrderBuffer::sortByKeys(const QList<QList<qint64>>& sortKeys, const QList<Qt::SortOrder>& sortOrders)
+{
+	assert(sortKeys.size() == sortOrders.size());
+	for (const QList<qint64>& passKeys : sortKeys) {
+		assert(passKeys.size() == order.size());
+	}
+	
+	QList<int> permutation = QList<int>(order.size());
+	std::iota(permutation.begin(), permutation.end(), 0);
+	std::stable_sort(permutation.begin(), permutation.end(), [&sortKeys, &sortOrders] (int position1, int position2) {
+		for (int pass = 0; pass < sortKeys.size(); pass++) {
+			const qint64 key1 = sortKeys.at(pass).at(position1);
+			const qint64 key2 = sortKeys.at(pass).at(position2);
+			if (key1 == key2) continue;
+			return (key1 < key2) == (sortOrders.at(pass) == Qt::AscendingOrder);
+		}
+		return false;
+	});
+	
+	QList<BufferRowIndex> sortedOrder = QList<BufferRowIndex>();
+	sortedOrder.reserve(order.size());
+	for (const int position : permutation) {
+		sortedOrder.append(order.at(position));
+	}
+	order = sortedOrder;
+	updateViewRows(0, order.size() - 1);
+}
+
+
+/**
+ * Stores the given view row index for the given buffer row index in the inverse of the order
+ * buffer, growing it if necessary.
+ * 
+ * @param bufferRowIndex	The buffer row index whose view row index to set.
+ * @param viewRow			The view row index at which the buffer row index is stored, or -1.
+ */
+void ViewOrderBuffer::setViewRowFor(BufferRowIndex bufferRowIndex, int viewRow)
+{
+	assert(bufferRowIndex.isValid());
+	if (bufferRowIndex.get() >= viewRowsByBufferRow.size()) {
+		if (viewRow < 0) return;
+		viewRowsByBufferRow.resize(bufferRowIndex.get() + 1, -1);
+	}
+	viewRowsByBufferRow[bufferRowIndex.get()] = viewRow;
+}
+
+/**
+ * Updates the inverse of the order buffer for all buffer row indices stored in the given range of
+ * view rows.
+ * 
+ * @param firstViewRow	The first view row index whose entry might have moved.
+ * @param lastViewRow	The last view row index whose entry might have moved.
+ */
+void ViewOrderBuffer::updateViewRows(int firstViewRow, int lastViewRow)
+{
+	for (int viewRow = firstViewRow; viewRow <= lastViewRow; viewRow++) {
+		setViewRowFor(order.at(viewRow), viewRow);
+	}
+}
+
+/**
+ * Rebuilds the inverse of the order buffer from scratch.
  */
-void ViewOrderBuffer::sortBy(std::function<bool (const BufferRowIndex&, const BufferRowIndex&)> comparator)
+void ViewOrderBuffer::rebuildViewRows()
 {
-	std::stable_sort(order.begin(), order.end(), comparator);
+	viewRowsByBufferRow.fill(-1);
+	updateViewRows(0, order.size() - 1);
 }
@@ -26,20 +26,74 @@
 
 #include "qvariant.h"
 #include "src/db/row_index.h"
+#include "src/db/db_data_type.h"
 
 #include "QList"
 
+#include <vector>
+
 
 
 /**
  * A class encapsulating a buffer for a Table or a CompositeTable.
+ * 
+ * The buffer is stored column by column. Columns of database tables are stored in typed,
+ * contiguous arrays (integers for IDs, integers and enums, packed bits for booleans, day numbers
+ * for dates, milliseconds since midnight for times and offsets into a shared string arena for
+ * strings). Columns of composite tables, which can contain arbitrary values, are stored as
+ * QVariants. A column can also be shared with another buffer, in which case its cells are read
+ * from the other buffer and not stored at all.
+ * 
+ * Regardless of storage, cells are read and written as QVariants. For generic and shared columns, a
+ * formatted version of each cell can be cached, which is discarded whenever the cell changes. Since
+ * changes to the cells of a shared column happen in the source buffer, the owner of this buffer has
+ * to discard the cached formatted cells of shared columns itself.
  */
 class TableBuffer {
+	/** The ways in which the cells of a single column can be stored. */
+	enum ColumnStorage {
+		GenericStorage,
+		IntStorage,
+		BitStorage,
+		DateStorage,
+		TimeStorage,
+		StringStorage,
+		SharedStorage
+	};
+	
+	/**
+	 * The storage for all cells of a single column.
+	 * 
+	 * Only the members matching the storage type are in use.
+	 */
+	struct BufferColumn {
+		/** The way in which the cells of this column are stored. */
+		ColumnStorage storage;
+		/** The cells of a generic column. */
+		QList<QVariant> variants;
+		/** The integers, day numbers, milliseconds since midnight or string arena offsets of a typed column. */
+		QList<qint32> values;
+		/** The lengths of the strings in the string arena for a string column. */
+		QList<qint32> stringLengths;
+		/** The packed values of a bit column, or the packed null flags of any other typed column. */
+		std::vector<bool> bits;
+		/** The cached formatted values of the cells of a generic or shared column, invalid where not cached, or empty if nothing is cached. */
+		mutable QList<QVariant> formattedVariants;
+		/** The buffer containing the cells of a shared column. */
+		const TableBuffer* sourceBuffer;
+		/** The index of the column containing the cells of a shared column in the source buffer. */
+		int sourceColumnIndex;
+	};
+	
 protected:
-	/** The number of columns currently represented in each row of the buffer. */
-	int numColumns;
-	/** The buffer. */
-	QList<QList<QVariant>*> buffer;
+	/** The number of rows in the buffer. */
+	int rowCount;
+	/** The columns of the buffer. */
+	QList<BufferColumn> bufferColumns;
+	/** The concatenated contents of all string cells in the buffer, including unused segments. */
+	QString stringArena;
+	/** The number of characters in the string arena which are no longer in use. */
+	int stringArenaGarbage;
 	
 public:
 	TableBuffer();
@@ -47,29 +101,68 @@ public:
 	
 	void reset();
 	void setInitialNumberOfColumns(int initialNumColumns);
+	void setInitialColumnTypes(const QList<DataType>& columnTypes);
 	
 	int numRows() const;
 	bool isEmpty() const;
 	
-	const QList<QVariant>* getRow(BufferRowIndex rowIndex) const;
+	QList<QVariant> getRow(BufferRowIndex rowIndex) const;
 	QVariant getCell(BufferRowIndex rowIndex, int columnIndex) const;
+	bool getIntegerColumn(int columnIndex, DataType type, const QList<qint32>*& values, const std::vector<bool>*& nullFlags) const;
+	bool getBitColumn(int columnIndex, const std::vector<bool>*& bits) const;
+	bool getStringColumn(int columnIndex, const QString*& arena, const QList<qint32>*& offsets, const QList<qint32>*& lengths, const std::vector<bool>*& nullFlags) const;
+	QVariant getCachedFormattedCell(BufferRowIndex rowIndex, int columnIndex) const;
+	void cacheFormattedCell(BufferRowIndex rowIndex, int columnIndex, const QVariant& formattedValue) const;
+	void discardFormattedCell(BufferRowIndex rowIndex, int columnIndex);
+	void discardFormattedColumn(int columnIndex);
 	
-	void appendRow(QList<QVariant>* newRow);
-	void insertRow(BufferRowIndex rowIndex, QList<QVariant>* newRow);
+	void appendRow(const QList<QVariant>& newRow);
+	void insertRow(BufferRowIndex rowIndex, const QList<QVariant>& newRow);
 	void removeRow(BufferRowIndex rowIndex);
 	void replaceCell(BufferRowIndex rowIndex, int columnIndex, const QVariant& newValue);
 	
 	void appendColumn();
+	void shareColumn(int columnIndex, const TableBuffer& sourceBuffer, int sourceColumnIndex);
 	void removeColumn(int columnIndex);
 	
-	QList<QList<QVariant>*>::const_iterator begin() const;
-	QList<QList<QVariant>*>::const_iterator end() const;
+private:
+	static ColumnStorage getStorageFor(DataType type);
+	static BufferColumn createColumn(ColumnStorage storage, int numRows);
+	
+	QVariant readCell(const BufferColumn& column, int rowIndex) const;
+	void writeCell(BufferColumn& column, int rowIndex, const QVariant& newValue);
+	void releaseString(const BufferColumn& column, int rowIndex);
+	void compactStringArenaIfWorthwhile();
 };
 
 
 
 
 
+/**
+ * A set of buffer rows, stored as a bitset with one bit per row in the buffer.
+ * 
+ * Used to combine the results of several filters word by word before the order buffer is rebuilt.
+ */
+class BufferRowSelection {
+	/** The number of rows in the buffer. */
+	int numBufferRows;
+	/** The bits for all rows, 64 rows per word. Unused bits in the last word are always zero. */
+	QList<quint64> words;
+	
+public:
+	BufferRowSelection(int numBufferRows, bool selectAll);
+	
+	int size() const;
+	bool contains(BufferRowIndex rowIndex) const;
+	QList<BufferRowIndex> getSelectedRows() const;
+	
+	void select(BufferRowIndex rowIndex);
+	void intersect(const BufferRowSelection& other);
+};
+
+
+
 /**
  * A class encapsulating an order buffer (a list of ViewOrderBuffer) for a CompositeTable.
  */
@@ -77,6 +170,8 @@ class ViewOrderBuffer {
 protected:
 	/** The order buffer. */
 	QList<BufferRowIndex> order;
+	/** The inverse of the order buffer: for each buffer row index, the view row index at which it is stored, or -1 if it is not. */
+	QList<int> viewRowsByBufferRow;
 	
 public:
 	ViewOrderBuffer();
@@ -86,15 +181,28 @@ public:
 	int numRows() const;
 	bool isEmpty() const;
 	
+	const QList<BufferRowIndex>& getBufferRowIndices() const;
 	BufferRowIndex getBufferRowIndexForViewRow(ViewRowIndex viewRowIndex) const;
 	ViewRowIndex findViewRowIndexForBufferRow(BufferRowIndex bufferRowIndex) const;
 	
 	void append(BufferRowIndex rowIndex);
+	void insert(ViewRowIndex viewRowIndex, BufferRowIndex rowIndex);
 	void removeViewRow(ViewRowIndex viewRowIndex);
+	void moveViewRow(ViewRowIndex fromViewRowIndex, ViewRowIndex toViewRowIndex);
+	void adjustForInsertedBufferRow(BufferRowIndex insertedRowIndex);
+	void adjustForRemovedBufferRow(BufferRowIndex removedRowIndex);
 	void replaceBufferRowIndexAtViewRowIndex(ViewRowIndex viewRowIndex, BufferRowIndex newBufferRowIndex);
 	
+	BufferRowSelection getSelection(int numBufferRows) const;
+	void retainSelected(const BufferRowSelection& selection);
+	
 	void reverse();
-	void sortBy(std::function<bool (const BufferRowIndex&, const BufferRowIndex&)> comparator);
+	void sortByKeys(const QList<QList<qint64>>& sortKeys, const QList<Qt::SortOrder>& sortOrders);
+	
+private:
+	void setViewRowFor(BufferRowIndex bufferRowIndex, int viewRow);
+	void updateViewRows(int firstViewRow, int lastViewRow);
+	void rebuildViewRows();
 };
 
 
@@ -50,13 +50,23 @@ public:
 	virtual inline ~TableChangeListener()
 	{}
 	
+	/**
+	 * This method is called before data in the database is changed.
+	 * 
+	 * Listeners which read the database from other threads must make sure here that they are done
+	 * before returning.
+	 */
+	virtual inline void dataAboutToChange() const
+	{}
+	
 	/**
 	 * This method is called after any data in the database was changed.
 	 * 
 	 * @param affectedColumns				The columns whose data has been changed.
 	 * @param rowsAddedOrRemovedPerTable	The rows that have been added or removed from the table. The bool indicates whether the row was added (true) or removed (false).
+	 * @param changedRowsPerColumn			The rows in which existing cells have been changed, for each affected column.
 	 */
-	virtual void dataChanged(const QSet<const Column*>& affectedColumns, const QHash<const Table*, QList<QPair<BufferRowIndex, bool>>>& rowsAddedOrRemovedPerTable) const = 0;
+	virtual void dataChanged(const QSet<const Column*>& affectedColumns, const QHash<const Table*, QList<QPair<BufferRowIndex, bool>>>& rowsAddedOrRemovedPerTable, const QHash<const Column*, QSet<BufferRowIndex>>& changedRowsPerColumn) const = 0;
 };
 
 
@@ -31,18 +31,17 @@ BoolFilter::~BoolFilter()
 
 
 
-bool BoolFilter::evaluate(const QVariant& rawRowValue) const
+void BoolFilter::selectPassingRows(const BufferRowSelection& candidateRows, BufferRowSelection& passingRows) const
 {
-	if (rawRowValue.isNull()) {
-		return isInverted();
-	}
-	else {
-		assert(rawRowValue.canConvert<bool>());
-		const bool convertedValue = rawRowValue.toBool();
-		const bool match = convertedValue == value;
+	const bool value = this->value;
+	const bool inverted = isInverted();
+	
+	selectRowsWhereBit(candidateRows, passingRows, [value, inverted] (bool rowValue, bool isNull) {
+		if (isNull) return inverted;
 		
-		return match != isInverted();
-	}
+		const bool match = rowValue == value;
+		return match != inverted;
+	});
 }
 
 
@@ -32,21 +32,22 @@ DateFilter::~DateFilter()
 
 
 
-bool DateFilter::evaluate(const QVariant& rawRowValue) const
+void DateFilter::selectPassingRows(const BufferRowSelection& candidateRows, BufferRowSelection& passingRows) const
 {
 	assert(!min.isNull());
 	assert(!max.isNull());
 	
-	if (rawRowValue.isNull()) {
-		return isInverted();
-	}
-	else {
-		assert(rawRowValue.canConvert<QDate>() && rawRowValue.toDate().isValid());
-		const QDate convertedValue = rawRowValue.toDate();
-		const bool match = convertedValue >= min && convertedValue <= max;
+	// Compare dates as day numbers
+	const qint64 minDay = min.toJulianDay();
+	const qint64 maxDay = max.toJulianDay();
+	const bool inverted = isInverted();
+	
+	selectRowsWhereInteger(candidateRows, passingRows, [minDay, maxDay, inverted] (qint32 rowDay, bool isNull) {
+		if (isNull) return inverted;
 		
-		return match != isInverted();
-	}
+		const bool match = rowDay >= minDay && rowDay <= maxDay;
+		return match != inverted;
+	});
 }
 
 
@@ -33,7 +33,7 @@ public:
 	DateFilter(const CompositeTable& tableToFilter, const CompositeColumn& columnToFilterBy, const QString& uiName);
 	virtual ~DateFilter();
 	
-	virtual bool evaluate(const QVariant& rawRowValue) const override;
+	virtual void selectPassingRows(const BufferRowSelection& candidateRows, BufferRowSelection& passingRows) const override;
 	
 	virtual FilterBox* createFilterBox(QWidget* parent) override;
 	
@@ -32,7 +32,7 @@ DualEnumFilter::~DualEnumFilter()
 
 
 
-bool DualEnumFilter::evaluate(const QVariant& rawRowValue) const
+void DualEnumFilter::selectPassingRows(const BufferRowSelection& candidateRows, BufferRowSelection& passingRows) const
 {
 	assert(discerningValue >= 0);
 	assert(dependentValue  >= 0);
@@ -61,40 +61,21 @@ bool DualEnumFilter::evaluate(const QVariant& rawRowValue) const
 	 * ╚═══════════╧══════════╩═══════════════╧════════╧═══════════════════╧═══════════╝
 	 */
 	
-	if (rawRowValue.isNull()) {
-		return (discerningValue == 0) != isInverted();
-	}
-	else {
-		assert(rawRowValue.canConvert<QVariantList>());
-		const QVariantList convertedList = rawRowValue.value<QVariantList>();
-		
-		if (convertedList.isEmpty()) {
-			return (discerningValue == 0) != isInverted();
-		}
-		
-		assert(convertedList.size() == 2);
-		assert(convertedList.at(0).canConvert<int>());
-		assert(convertedList.at(1).canConvert<int>());
-		const int convertedDiscerning	= convertedList.at(0).toInt();
-		const int convertedDependent	= convertedList.at(1).toInt();
-		assert((convertedDiscerning > 0) == (convertedDependent > 0));
+	const int discerningValue	= this->discerningValue;
+	const int dependentValue	= this->dependentValue;
+	const bool inverted = isInverted();
+	const bool passIfEmpty = (discerningValue == 0) != inverted;
+	
+	selectRowsWhereDualEnum(candidateRows, passingRows, [discerningValue, dependentValue, inverted, passIfEmpty] (qint32 rowDiscerning, qint32 rowDependent, bool isNull) {
+		if (isNull) return passIfEmpty;
 		
-		if (convertedDiscerning == 0) {
-			return (discerningValue == 0) != isInverted();
-		}
-		else {
-			const bool discerningMatch = convertedDiscerning == discerningValue;
-			const bool  dependentMatch = convertedDependent  == dependentValue;
-			const bool bothMatch = discerningMatch && dependentMatch;
-			
-			if (dependentValue == 0) {
-				return discerningMatch != isInverted();
-			}
-			else {
-				return bothMatch != isInverted();
-			}
+		const bool discerningMatch = rowDiscerning == discerningValue;
+		const bool  dependentMatch = rowDependent  == dependentValue;
+		if (dependentValue == 0) {
+			return discerningMatch != inverted;
 		}
-	}
+		return (discerningMatch && dependentMatch) != inverted;
+	});
 }
 
 
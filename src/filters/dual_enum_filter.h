@@ -31,7 +31,7 @@ public:
 	DualEnumFilter(const CompositeTable& tableToFilter, const CompositeColumn& columnToFilterBy, const QString& uiName);
 	virtual ~DualEnumFilter();
 	
-	virtual bool evaluate(const QVariant& rawRowValue) const override;
+	virtual void selectPassingRows(const BufferRowSelection& candidateRows, BufferRowSelection& passingRows) const override;
 	
 	virtual FilterBox* createFilterBox(QWidget* parent) override;
 	
@@ -31,18 +31,17 @@ EnumFilter::~EnumFilter()
 
 
 
-bool EnumFilter::evaluate(const QVariant& rawRowValue) const
+void EnumFilter::selectPassingRows(const BufferRowSelection& candidateRows, BufferRowSelection& passingRows) const
 {
-	if (rawRowValue.isNull()) {
-		return isInverted();
-	}
-	else {
-		assert(rawRowValue.canConvert<int>());
-		const int convertedValue = rawRowValue.toInt();
-		const bool match = convertedValue == value;
+	const int value = this->value;
+	const bool inverted = isInverted();
+	
+	selectRowsWhereInteger(candidateRows, passingRows, [value, inverted] (qint32 rowValue, bool isNull) {
+		if (isNull) return inverted;
 		
-		return match != isInverted();
-	}
+		const bool match = rowValue == value;
+		return match != inverted;
+	});
 }
 
 
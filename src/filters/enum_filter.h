@@ -30,7 +30,7 @@ public:
 	EnumFilter(const CompositeTable& tableToFilter, const CompositeColumn& columnToFilterBy, const QString& uiName);
 	virtual ~EnumFilter();
 	
-	virtual bool evaluate(const QVariant& rawRowValue) const override;
+	virtual void selectPassingRows(const BufferRowSelection& candidateRows, BufferRowSelection& passingRows) const override;
 	
 	virtual FilterBox* createFilterBox(QWidget* parent) override;
 	
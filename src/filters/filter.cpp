@@ -72,31 +72,47 @@ void Filter::setInverted(bool inverted)
 
 
 
-void Filter::applyToOrderBuffer(ViewOrderBuffer& viewOrderBuffer) const
+BufferRowSelection Filter::evaluateForRows(const BufferRowSelection& candidateRows) const
 {
-	for (ViewRowIndex viewRow = ViewRowIndex(viewOrderBuffer.numRows() - 1); viewRow.isValid(); viewRow--) {
-		const BufferRowIndex bufferRow = viewOrderBuffer.getBufferRowIndexForViewRow(viewRow);
-		
-		// Get raw value
-		QVariant rawRowValue;
-		if (type == ID) {
-			const QSet<ValidItemID> ids = columnToFilterBy.computeIDsAt(bufferRow);
-			QVariantList idsAsVariants = QVariantList();
-			for (const ValidItemID& id : ids) {
-				idsAsVariants.append(id.asQVariant());
-			}
-			rawRowValue = QVariant(idsAsVariants);
-		} else {
-			rawRowValue = columnToFilterBy.getRawValueAt(bufferRow);
-		}
-		
-		// Evaluate filter
-		const bool pass = evaluate(rawRowValue);
-		
-		// Remove row if no match
-		if (!pass) {
-			viewOrderBuffer.removeViewRow(viewRow);
-		}
+	BufferRowSelection passingRows = BufferRowSelection(candidateRows.size(), false);
+	selectPassingRows(candidateRows, passingRows);
+	return passingRows;
+}
+
+/**
+ * Converts a raw cell value to the integer representation used by selectRowsWhereInteger().
+ * 
+ * @param type		The type of the cell. Must be Integer, ID, Enum, Date or Time.
+ * @param rawValue	The raw value of the cell.
+ * @param isNull	Set to whether the cell is empty.
+ * @return			The integer representation of the cell, or 0 if it is empty.
+ */
+qint32 Filter::toIntegerCell(DataType type, const QVariant& rawValue, bool& isNull)
+{
+	isNull = !rawValue.isValid() || rawValue.isNull();
+	if (isNull) return 0;
+	
+	switch (type) {
+	case Integer:
+	case ID:
+	case Enum:
+		assert(rawValue.canConvert<int>());
+		return rawValue.toInt();
+	case Date: {
+		assert(rawValue.canConvert<QDate>());
+		const QDate date = rawValue.toDate();
+		isNull = !date.isValid();
+		return isNull ? 0 : (qint32) date.toJulianDay();
+	}
+	case Time: {
+		assert(rawValue.canConvert<QTime>());
+		const QTime time = rawValue.toTime();
+		isNull = !time.isValid();
+		return isNull ? 0 : time.msecsSinceStartOfDay();
+	}
+	default:
+		assert(false);
+		return 0;
 	}
 }
 
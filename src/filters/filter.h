@@ -53,9 +53,19 @@ public:
 	void setEnabled(bool enabled);
 	void setInverted(bool inverted);
 	
-	void applyToOrderBuffer(ViewOrderBuffer& viewOrderBuffer) const;
+	BufferRowSelection evaluateForRows(const BufferRowSelection& candidateRows) const;
 protected:
-	virtual bool evaluate(const QVariant& rawRowValue) const = 0;
+	virtual void selectPassingRows(const BufferRowSelection& candidateRows, BufferRowSelection& passingRows) const = 0;
+	template<typename Predicate>
+	void selectRowsWhereInteger(const BufferRowSelection& candidateRows, BufferRowSelection& passingRows, Predicate predicate) const;
+	template<typename Predicate>
+	void selectRowsWhereBit(const BufferRowSelection& candidateRows, BufferRowSelection& passingRows, Predicate predicate) const;
+	template<typename Predicate>
+	void selectRowsWhereString(const BufferRowSelection& candidateRows, BufferRowSelection& passingRows, Predicate predicate) const;
+	template<typename Predicate>
+	void selectRowsWhereDualEnum(const BufferRowSelection& candidateRows, BufferRowSelection& passingRows, Predicate predicate) const;
+private:
+	static qint32 toIntegerCell(DataType type, const QVariant& rawValue, bool& isNull);
 	
 public:
 	virtual FilterBox* createFilterBox(QWidget* parent) = 0;
@@ -75,4 +85,177 @@ protected:
 
 
 
+/**
+ * Selects all candidate rows for which the given predicate returns true when applied to the value
+ * of the filtered column in that row in its integer representation.
+ * 
+ * Integers and enums are passed as they are, dates as day numbers and times as milliseconds since
+ * midnight. If the column's cells are stored as integers in the buffer, they are read from there
+ * directly. Otherwise, the raw value of each row is converted.
+ * 
+ * @param candidateRows	The buffer rows to evaluate.
+ * @param passingRows	The selection to add all rows to which pass the predicate.
+ * @param predicate		The compiled filter predicate, taking the integer value as qint32 and whether the cell is empty as bool.
+ */
+template<typename Predicate>
+void Filter::selectRowsWhereInteger(const BufferRowSelection& candidateRows, BufferRowSelection& passingRows, Predicate predicate) const
+{
+	const QList<qint32>* values = nullptr;
+	const std::vector<bool>* nullFlags = nullptr;
+	
+	if (columnToFilterBy.getIntegerCells(values, nullFlags)) {
+		for (const BufferRowIndex& bufferRow : candidateRows.getSelectedRows()) {
+			const int row = bufferRow.get();
+			if (predicate(values->at(row), (bool) (*nullFlags)[row])) {
+				passingRows.select(bufferRow);
+			}
+		}
+		return;
+	}
+	
+	const DataType contentType = columnToFilterBy.contentType;
+	for (const BufferRowIndex& bufferRow : candidateRows.getSelectedRows()) {
+		bool isNull = false;
+		const qint32 value = toIntegerCell(contentType, columnToFilterBy.getRawValueAt(bufferRow), isNull);
+		if (predicate(value, isNull)) {
+			passingRows.select(bufferRow);
+		}
+	}
+}
+
+/**
+ * Selects all candidate rows for which the given predicate returns true when applied to the
+ * boolean value of the filtered column in that row.
+ * 
+ * If the column's cells are stored as bits in the buffer, they are read from there directly.
+ * Otherwise, the raw value of each row is converted.
+ * 
+ * @param candidateRows	The buffer rows to evaluate.
+ * @param passingRows	The selection to add all rows to which pass the predicate.
+ * @param predicate		The compiled filter predicate, taking the boolean value as bool and whether the cell is empty as bool.
+ */
+template<typename Predicate>
+void Filter::selectRowsWhereBit(const BufferRowSelection& candidateRows, BufferRowSelection& passingRows, Predicate predicate) const
+{
+	const std::vector<bool>* bits = nullptr;
+	
+	if (columnToFilterBy.getBitCells(bits)) {
+		for (const BufferRowIndex& bufferRow : candidateRows.getSelectedRows()) {
+			if (predicate((bool) (*bits)[bufferRow.get()], false)) {
+				passingRows.select(bufferRow);
+			}
+		}
+		return;
+	}
+	
+	for (const BufferRowIndex& bufferRow : candidateRows.getSelectedRows()) {
+		const QVariant rawValue = columnToFilterBy.getRawValueAt(bufferRow);
+		const bool isNull = rawValue.isNull();
+		assert(isNull || rawValue.canConvert<bool>());
+		if (predicate(!isNull && rawValue.toBool(), isNull)) {
+			passingRows.select(bufferRow);
+		}
+	}
+}
+
+/**
+ * Selects all candidate rows for which the given predicate returns true when applied to the string
+ * value of the filtered column in that row.
+ * 
+ * If the column's cells are stored in a string arena in the buffer, they are viewed in place.
+ * Otherwise, the raw value of each row is converted.
+ * 
+ * @param candidateRows	The buffer rows to evaluate.
+ * @param passingRows	The selection to add all rows to which pass the predicate.
+ * @param predicate		The compiled filter predicate, taking the string value as QStringView and whether the cell is empty as bool.
+ */
+template<typename Predicate>
+void Filter::selectRowsWhereString(const BufferRowSelection& candidateRows, BufferRowSelection& passingRows, Predicate predicate) const
+{
+	const QString* arena = nullptr;
+	const QList<qint32>* offsets = nullptr;
+	const QList<qint32>* lengths = nullptr;
+	const std::vector<bool>* nullFlags = nullptr;
+	
+	if (columnToFilterBy.getStringCells(arena, offsets, lengths, nullFlags)) {
+		const QStringView arenaView = QStringView(*arena);
+		for (const BufferRowIndex& bufferRow : candidateRows.getSelectedRows()) {
+			const int row = bufferRow.get();
+			const QStringView value = arenaView.mid(offsets->at(row), lengths->at(row));
+			if (predicate(value, (bool) (*nullFlags)[row])) {
+				passingRows.select(bufferRow);
+			}
+		}
+		return;
+	}
+	
+	for (const BufferRowIndex& bufferRow : candidateRows.getSelectedRows()) {
+		const QVariant rawValue = columnToFilterBy.getRawValueAt(bufferRow);
+		const bool isNull = rawValue.isNull();
+		assert(isNull || rawValue.canConvert<QString>());
+		const QString value = isNull ? QString() : rawValue.toString();
+		if (predicate(QStringView(value), isNull)) {
+			passingRows.select(bufferRow);
+		}
+	}
+}
+
+/**
+ * Selects all candidate rows for which the given predicate returns true when applied to the pair of
+ * enum values of the filtered column in that row.
+ * 
+ * If the column's cells are computed from two integer columns in a buffer, they are read from
+ * there directly. Otherwise, the raw value of each row is converted. A cell counts as empty unless
+ * both values are greater than 0, in which case both values passed to the predicate are 0.
+ * 
+ * @param candidateRows	The buffer rows to evaluate.
+ * @param passingRows	The selection to add all rows to which pass the predicate.
+ * @param predicate		The compiled filter predicate, taking the discerning and displayed enum values as qint32 and whether the cell is empty as bool.
+ */
+template<typename Predicate>
+void Filter::selectRowsWhereDualEnum(const BufferRowSelection& candidateRows, BufferRowSelection& passingRows, Predicate predicate) const
+{
+	const QList<qint32>* discerningValues = nullptr;
+	const std::vector<bool>* discerningNullFlags = nullptr;
+	const QList<qint32>* displayedValues = nullptr;
+	const std::vector<bool>* displayedNullFlags = nullptr;
+	
+	if (columnToFilterBy.getDualEnumCells(discerningValues, discerningNullFlags, displayedValues, displayedNullFlags)) {
+		for (const BufferRowIndex& bufferRow : candidateRows.getSelectedRows()) {
+			const int row = bufferRow.get();
+			const qint32 discerning	= (*discerningNullFlags)[row]	? 0 : discerningValues->at(row);
+			const qint32 displayed	= (*displayedNullFlags)[row]	? 0 : displayedValues->at(row);
+			const bool isNull = discerning < 1 || displayed < 1;
+			if (predicate(isNull ? 0 : discerning, isNull ? 0 : displayed, isNull)) {
+				passingRows.select(bufferRow);
+			}
+		}
+		return;
+	}
+	
+	for (const BufferRowIndex& bufferRow : candidateRows.getSelectedRows()) {
+		const QVariant rawValue = columnToFilterBy.getRawValueAt(bufferRow);
+		qint32 discerning = 0;
+		qint32 displayed = 0;
+		if (!rawValue.isNull()) {
+			assert(rawValue.canConvert<QVariantList>());
+			const QVariantList convertedList = rawValue.value<QVariantList>();
+			if (!convertedList.isEmpty()) {
+				assert(convertedList.size() == 2);
+				assert(convertedList.at(0).canConvert<int>());
+				assert(convertedList.at(1).canConvert<int>());
+				discerning	= convertedList.at(0).toInt();
+				displayed	= convertedList.at(1).toInt();
+				assert((discerning > 0) == (displayed > 0));
+			}
+		}
+		const bool isNull = discerning < 1 || displayed < 1;
+		if (predicate(isNull ? 0 : discerning, isNull ? 0 : displayed, isNull)) {
+			passingRows.select(bufferRow);
+		}
+	}
+}
+
+
+
 #endif // FILTER_H
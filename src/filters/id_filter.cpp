@@ -38,7 +38,7 @@ IDFilter::~IDFilter()
 
 
 
-bool IDFilter::evaluate(const QVariant& rawRowValue) const
+void IDFilter::selectPassingRows(const BufferRowSelection& candidateRows, BufferRowSelection& passingRows) const
 {
 	/*                              ╔═══════════════════════════════════════════════╗
 	 *                              ║           Value from filtered table           ║
@@ -55,34 +55,30 @@ bool IDFilter::evaluate(const QVariant& rawRowValue) const
 	 * ╚═══════════╧════════════════╩═══════════════╧════════════════╧══════════════╝
 	 */
 	
-	if (rawRowValue.isNull()) {
-		return value.isValid() == isInverted();
-	}
+	const bool inverted = isInverted();
 	
-	if (rawRowValue.canConvert<int>()) {
-		const ItemID convertedValue = ItemID(rawRowValue.toInt());
-		bool match;
-		if (convertedValue.isValid()) {
-			match = convertedValue == value;
-		} else {
-			match = value.isInvalid();
-		}
-		return match != isInverted();
+	const QList<BufferRowIndex> rowIndices = candidateRows.getSelectedRows();
+	
+	// Compare rows in the ID table instead of IDs, so no IDs need to be read
+	BufferRowIndex valueRow = BufferRowIndex();
+	if (value.isValid()) {
+		valueRow = columnToFilterBy.getIDTable().getBufferIndexForPrimaryKey(FORCE_VALID(value));
 	}
 	
-	if (rawRowValue.canConvert<QVariantList>()) {
-		const QVariantList list = rawRowValue.toList();
+	const BreadcrumbMapping mapping = columnToFilterBy.mapRowsToIDTable(rowIndices);
+	for (int position = 0; position < mapping.numStartRows(); position++) {
 		bool match;
 		if (value.isValid()) {
-			match = list.contains(value.asQVariant());
+			const auto end = mapping.targetRowsEnd(position);
+			match = valueRow.isValid() && std::find(mapping.targetRowsBegin(position), end, valueRow) != end;
 		} else {
-			match = list.isEmpty();
+			match = mapping.numTargetRowsFor(position) == 0;
+		}
+		
+		if (match != inverted) {
+			passingRows.select(rowIndices.at(position));
 		}
-		return match != isInverted();
 	}
-	
-	assert(false);
-	return false;
 }
 
 
@@ -30,7 +30,7 @@ public:
 	IDFilter(const CompositeTable& tableToFilter, const CompositeColumn& columnToFilterBy, const QString& uiName);
 	virtual ~IDFilter();
 	
-	virtual bool evaluate(const QVariant& rawRowValue) const override;
+	virtual void selectPassingRows(const BufferRowSelection& candidateRows, BufferRowSelection& passingRows) const override;
 	
 	virtual FilterBox* createFilterBox(QWidget* parent) override;
 	
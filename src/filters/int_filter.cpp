@@ -47,18 +47,18 @@ IntFilter::~IntFilter()
 
 
 
-bool IntFilter::evaluate(const QVariant& rawRowValue) const
+void IntFilter::selectPassingRows(const BufferRowSelection& candidateRows, BufferRowSelection& passingRows) const
 {
-	if (rawRowValue.isNull()) {
-		return isInverted();
-	}
-	else {
-		assert(rawRowValue.canConvert<int>());
-		const int convertedValue = rawRowValue.toInt();
-		const bool match = convertedValue >= min && convertedValue <= max;
+	const int min = this->min;
+	const int max = this->max;
+	const bool inverted = isInverted();
+	
+	selectRowsWhereInteger(candidateRows, passingRows, [min, max, inverted] (qint32 rowValue, bool isNull) {
+		if (isNull) return inverted;
 		
-		return match != isInverted();
-	}
+		const bool match = rowValue >= min && rowValue <= max;
+		return match != inverted;
+	});
 }
 
 
@@ -31,10 +31,13 @@ StringFilter::~StringFilter()
 
 
 
-bool StringFilter::evaluate(const QVariant& rawRowValue) const
+void StringFilter::selectPassingRows(const BufferRowSelection& candidateRows, BufferRowSelection& passingRows) const
 {
 	assert(!value.isNull());
-	if (value.isEmpty()) return true;
+	if (value.isEmpty()) {
+		passingRows = candidateRows;
+		return;
+	}
 	
 	/*                                ╔═════════════════════════════════════════════════╗
 	 *                                ║           Value from filtered table             ║
@@ -51,31 +54,22 @@ bool StringFilter::evaluate(const QVariant& rawRowValue) const
 	 * ╚═══════════╧══════════════════╩═══════════════╧══════════════╧══════════════════╝
 	 */
 	
-	if (rawRowValue.isNull()) {
-		return value.isEmpty() != isInverted();
-	}
-	else {
-		assert(rawRowValue.canConvert<QString>());
-		const QString convertedValue = rawRowValue.toString();
+	// Split search terms once instead of for every row
+	const QStringList searchTerms = value.split(" ");
+	const bool inverted = isInverted();
+	
+	selectRowsWhereString(candidateRows, passingRows, [&searchTerms, inverted] (QStringView rowValue, bool isNull) {
+		if (isNull || rowValue.isEmpty()) return inverted;
 		
-		if (convertedValue.isEmpty()) {
-			return value.isEmpty() != isInverted();
-		}
-		else if (value.isEmpty()) {
-			return isInverted();
-		}
-		else {
-			const QStringList split = value.split(" ");
-			bool containsAny = false;
-			for (const QString& string : split) {
-				if (convertedValue.contains(string, Qt::CaseInsensitive)) {
-					containsAny = true;
-					break;
-				}
+		bool containsAny = false;
+		for (const QString& searchTerm : searchTerms) {
+			if (rowValue.contains(searchTerm, Qt::CaseInsensitive)) {
+				containsAny = true;
+				break;
 			}
-			return containsAny != isInverted();
 		}
-	}
+		return containsAny != inverted;
+	});
 }
 
 
@@ -32,21 +32,22 @@ TimeFilter::~TimeFilter()
 
 
 
-bool TimeFilter::evaluate(const QVariant& rawRowValue) const
+void TimeFilter::selectPassingRows(const BufferRowSelection& candidateRows, BufferRowSelection& passingRows) const
 {
 	assert(!min.isNull());
 	assert(!max.isNull());
 	
-	if (rawRowValue.isNull()) {
-		return isInverted();
-	}
-	else {
-		assert(rawRowValue.canConvert<QTime>() && rawRowValue.toTime().isValid());
-		const QTime convertedValue = rawRowValue.toTime();
-		const bool match = convertedValue >= min && convertedValue <= max;
+	// Compare times as milliseconds since midnight
+	const int minMSecs = min.msecsSinceStartOfDay();
+	const int maxMSecs = max.msecsSinceStartOfDay();
+	const bool inverted = isInverted();
+	
+	selectRowsWhereInteger(candidateRows, passingRows, [minMSecs, maxMSecs, inverted] (qint32 rowMSecs, bool isNull) {
+		if (isNull) return inverted;
 		
-		return match != isInverted();
-	}
+		const bool match = rowMSecs >= minMSecs && rowMSecs <= maxMSecs;
+		return match != inverted;
+	});
 }
 
 
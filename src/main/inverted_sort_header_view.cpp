@@ -29,7 +29,7 @@
 
 
 
-InvertedSortHeaderView::InvertedSortHeaderView(QWidget* parent, const CompositeTable& table) :
+InvertedSortHeaderView::InvertedSortHeaderView(QWidget* parent, CompositeTable& table) :
 	QHeaderView(Qt::Orientation::Horizontal, parent),
 	table(table)
 {}
@@ -50,6 +50,19 @@ void InvertedSortHeaderView::mousePressEvent(QMouseEvent* event)
 	const bool invertDefaultOrder = isNumericColumn && Settings::sortNumericColumnsDescendingByDefault.get();
 	const bool applyInvertedDefaultOrder = applyDefaultOrder && invertDefaultOrder;
 	
+	if (event->button() == Qt::LeftButton && event->modifiers() & Qt::ShiftModifier) {
+		if (applyDefaultOrder) {
+			// Shift-click: sort additionally by this column, keeping the sort indicator on the first one
+			table.addSecondarySorting(logicalIndex, invertDefaultOrder ? Qt::DescendingOrder : Qt::AscendingOrder);
+		} else {
+			// Shift-click on primary sort column: reverse it, keeping all secondary sortings
+			const Qt::SortOrder reversedOrder = sortIndicatorOrder() == Qt::AscendingOrder ? Qt::DescendingOrder : Qt::AscendingOrder;
+			setSortIndicator(logicalIndex, reversedOrder);
+		}
+		event->accept();
+		return;
+	}
+	
 	if (applyInvertedDefaultOrder) {
 		// Default to decending
 		const bool oldBlockState = this->blockSignals(true);
@@ -34,10 +34,10 @@ class InvertedSortHeaderView : public QHeaderView
 {
 	Q_OBJECT
 	
-	const CompositeTable& table;
+	CompositeTable& table;
 	
 public:
-	InvertedSortHeaderView(QWidget* parent, const CompositeTable& table);
+	InvertedSortHeaderView(QWidget* parent, CompositeTable& table);
 	virtual ~InvertedSortHeaderView();
 	
 protected:
@@ -235,6 +235,8 @@ public:
 	 */
 	inline ~ItemTypeMapper()
 	{
+		// Background tasks read columns of the subclass, which are destroyed before the base class
+		compTable.waitForBackgroundTasks();
 		delete &compTable;
 		delete &statsEngine;
 		delete &columnWizard;
@@ -313,44 +313,21 @@ void MainWindow::attemptToOpenFile(const QString& filepath)
 }
 
 /**
- * Prepares the composite tables and fills either all of them or only the one currently being
- * shown, with a status bar progress dialog.
+ * Prepares the composite tables and starts filling either all of them or only the one currently
+ * being shown in the background.
  * 
- * If the user setting is to *not* prepare all tables on startup, all tables are still being
- * initialized (so as not to produce null pointer exceptions), but not filled with data.
+ * All tables are initialized right away (so as not to produce null pointer exceptions), but their
+ * contents are computed in the background, so that the window stays responsive and columns appear
+ * as soon as they are ready. If the user setting is to *not* prepare all tables on startup, the
+ * tables which are not shown are only filled once they are opened.
  */
 void MainWindow::initCompositeBuffers()
 {
-	QProgressDialog progress(this);
-	progress.setWindowFlags(progress.windowFlags() & ~Qt::WindowCloseButtonHint);
-	progress.setWindowModality(Qt::WindowModal);
-	progress.setWindowTitle(tr("Opening database"));
-	progress.setMinimumWidth(250);
-	progress.setCancelButton(nullptr);
-	progress.setMinimumDuration(100);
-	progress.setLabel(new QLabel(tr("Preparing tables..."), &progress));
-	
 	bool prepareAll = !Settings::onlyPrepareActiveTableOnStartup.get();
 	const ItemTypeMapper* const activeMapper = getActiveMapperOrNull();
 	const QTableView* const currentTableView = activeMapper ? &activeMapper->tableView : nullptr;
 	
-	int numCells = 0;
-	if (prepareAll) {
-		for (const ItemTypeMapper* const mapper : typesHandler->getAllMappers()) {
-			numCells += mapper->compTable.getNumberOfCellsToInit();
-		}
-	} else {
-		if (activeMapper) {
-			numCells += activeMapper->compTable.getNumberOfCellsToInit();
-		}
-	}
-	progress.setMinimum(0);
-	progress.setMaximum(numCells);
-	progress.setValue(0);
-	
 	for (ItemTypeMapper* const mapper : typesHandler->getAllMappers()) {
-		progress.setLabelText(tr("Preparing table %1...").arg(mapper->baseTable.uiName));
-		
 		const bool isOpen = &mapper->tableView == currentTableView;
 		
 		// Load filters
@@ -377,12 +354,11 @@ void MainWindow::initCompositeBuffers()
 		const QSet<QString> columnNameSet = mapper->compTable.getNormalColumnNameSet();
 		const bool autoResizeColumns = !Settings::rememberColumnWidths.get() || mapper->columnWidthsSetting.nonePresent(columnNameSet);
 		
-		// Collect buffer initialization parameters
-		QProgressDialog* const updateProgress = prepareThisTable ? &progress : nullptr;
-		const bool deferCompute = !prepareThisTable;
+		// Initialize buffer without computing, then compute in the background if necessary
 		QTableView* const tableToAutoResizeAfterCompute = autoResizeColumns ? &mapper->tableView : nullptr;
 		
-		mapper->compTable.initBuffer(updateProgress, deferCompute, tableToAutoResizeAfterCompute);
+		mapper->compTable.initBuffer(nullptr, true, tableToAutoResizeAfterCompute);
+		if (prepareThisTable) mapper->compTable.updateBothBuffersInBackground();
 		if (isOpen) mapper->openingTab();
 	}
 }
@@ -773,8 +749,8 @@ void MainWindow::updateSelectionAfterUserAction(const ItemTypeMapper& mapper, Vi
 /**
  * Event handler for changes in which tab is selected in the main tab widget.
  * 
- * Prepares the newly active table if necessary (with a progress dialog) and updates the table size
- * info and the enabled state of the table context menu actions.
+ * Starts preparing the newly active table in the background if necessary and updates the table
+ * size info and the enabled state of the table context menu actions.
  */
 void MainWindow::handle_tabChanged()
 {
@@ -784,15 +760,6 @@ void MainWindow::handle_tabChanged()
 	
 	updateItemCountDisplays();
 	
-	QProgressDialog progress(this);
-	progress.setWindowFlags(progress.windowFlags() & ~Qt::WindowCloseButtonHint);
-	progress.setWindowModality(Qt::WindowModal);
-	progress.setWindowTitle(tr("Updating table"));
-	progress.setLabel(new QLabel(tr("Updating table..."), &progress));
-	progress.setMinimumWidth(250);
-	progress.setCancelButton(nullptr);
-	progress.setMinimumDuration(100);
-	
 	for (const ItemTypeMapper* const mapper : typesHandler->getAllMappers()) {
 		if (mapper == activeMapper) continue;
 		
@@ -801,9 +768,8 @@ void MainWindow::handle_tabChanged()
 	}
 	
 	if (activeMapper) {
-		// Make sure active table is up to date
-		progress.setMaximum(activeMapper->compTable.getNumberOfCellsToUpdate());
-		activeMapper->compTable.setUpdateImmediately(true, &progress);
+		// Bring active table up to date in the background
+		activeMapper->compTable.setUpdateImmediately(true);
 		
 		const bool firstOpen = !activeMapper->tabHasBeenOpened(false);
 		activeMapper->openingTab();
@@ -958,7 +924,14 @@ void MainWindow::handle_saveDatabaseAs()
 		QFile(filepath).remove();
 	}
 	
-	bool success = db.saveAs(*this, filepath);
+	bool canceled = false;
+	bool success = db.saveAs(*this, filepath, canceled);
+	if (canceled) {
+		// Nothing to report, but make sure no incomplete copy is left behind
+		assert(!success);
+		if (QFile(filepath).exists()) QFile(filepath).remove();
+		return;
+	}
 	if (!success) {
 		QString title = tr("Save database as");
 		QString message = tr("Writing database file failed:")
@@ -1393,14 +1366,20 @@ void MainWindow::saveImplicitColumnSettings(const ItemTypeMapper& mapper)
 /**
  * Saves the sorting of the table for the given item type.
  * 
+ * All sorting passes are saved as semicolon-separated pairs of column name and order, starting
+ * with the primary one.
+ * 
  * @param mapper	The ItemTypeMapper containing the table whose sorting should be saved.
  */
 void MainWindow::saveSorting(const ItemTypeMapper& mapper)
 {
-	const auto& [column, order] = mapper.compTable.getCurrentSorting();
-	QString orderString = order == Qt::DescendingOrder ? "Descending" : "Ascending";
-	QString settingValue = column->name + ", " + orderString;
-	mapper.sortingSetting.set(*this, settingValue);
+	QStringList passStrings = QStringList();
+	for (const auto& [column, order] : mapper.compTable.getCurrentSortingPasses()) {
+		QString orderString = order == Qt::DescendingOrder ? "Descending" : "Ascending";
+		passStrings.append(column->name + ", " + orderString);
+	}
+	if (passStrings.isEmpty()) return;
+	mapper.sortingSetting.set(*this, passStrings.join("; "));
 }
 
 
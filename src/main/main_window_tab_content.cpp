@@ -192,30 +192,45 @@ void MainWindowTabContent::restoreColumnHiddenStatus()
 /**
  * Sets the sorting for the table view to either the remembered sorting or, if that is not present
  * or disabled, to the default sorting.
+ * 
+ * The remembered sorting can consist of multiple passes, which are applied in a single sort.
  */
 void MainWindowTabContent::setSorting()
 {
-	SortingPass sorting = compTable->getDefaultSorting();
+	QList<SortingPass> sortingPasses = { compTable->getDefaultSorting() };
 	bool sortingSettingValid = true;
 	
 	while (Settings::rememberSorting.get() && mapper->sortingSetting.present()) {
 		sortingSettingValid = false;
 		
-		QStringList saved = mapper->sortingSetting.get().split(",");
-		if (saved.size() != 2) break;
-		
-		const CompositeColumn* column = compTable->getColumnByNameOrNull(saved.at(0).trimmed());
-		if (!column) break;
-		
-		bool ascending = saved.at(1).trimmed().compare("Descending", Qt::CaseInsensitive) != 0;
-		Qt::SortOrder order = ascending ? Qt::AscendingOrder : Qt::DescendingOrder;
+		QList<SortingPass> savedPasses = QList<SortingPass>();
+		const QStringList savedPassStrings = mapper->sortingSetting.get().split(";");
+		for (const QString& savedPassString : savedPassStrings) {
+			QStringList saved = savedPassString.split(",");
+			if (saved.size() != 2) break;
+			
+			const CompositeColumn* column = compTable->getColumnByNameOrNull(saved.at(0).trimmed());
+			if (!column) break;
+			
+			bool ascending = saved.at(1).trimmed().compare("Descending", Qt::CaseInsensitive) != 0;
+			Qt::SortOrder order = ascending ? Qt::AscendingOrder : Qt::DescendingOrder;
+			
+			savedPasses.append({column, order});
+		}
+		if (savedPasses.size() != savedPassStrings.size()) break;
 		
-		sorting.column = column;
-		sorting.order = order;
+		sortingPasses = savedPasses;
 		sortingSettingValid = true;
 		break;
 	}
-	tableView->sortByColumn(sorting.column->getIndex(), sorting.order);
+	
+	// Show sort indicator for the primary sorting without triggering a separate sort
+	const SortingPass& primarySorting = sortingPasses.first();
+	QHeaderView* header = tableView->horizontalHeader();
+	const bool oldBlockState = header->blockSignals(true);
+	header->setSortIndicator(primarySorting.column->getIndex(), primarySorting.order);
+	header->blockSignals(oldBlockState);
+	compTable->setSorting(sortingPasses);
 	
 	if (!sortingSettingValid) mapper->sortingSetting.clear(*this);
 }
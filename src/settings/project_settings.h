@@ -33,6 +33,20 @@
 
 
 
+/**
+ * The profiles for trading off durability against speed of the SQLite database connection.
+ */
+enum DatabasePerformanceProfile {
+	/** Rollback journal and full synchronization, as with SQLite's defaults. */
+	SafePerformanceProfile,
+	/** Write-ahead log, normal synchronization and a moderately sized cache. */
+	BalancedPerformanceProfile,
+	/** Write-ahead log, no synchronization and a large cache. Recent changes can be lost on power failure. */
+	FastPerformanceProfile
+};
+
+
+
 /**
  * A class representing a project setting without a type.
  * 
@@ -119,6 +133,8 @@ public:
 	
 	/** The default hiker setting. */
 	ProjectSetting<int>			defaultHiker;
+	/** The performance profile for the database connection, as a DatabasePerformanceProfile. */
+	ProjectSetting<int>			performanceProfile;
 	
 	
 	// === INTERNAL STATE ===
@@ -262,6 +278,7 @@ public:
 		// === EXPLICIT PROJECT SETTINGS ===
 		
 		defaultHiker					(ProjectSetting<int>		(table,	"defaultHiker")),
+		performanceProfile				(ProjectSetting<int>		(table,	"performanceProfile",								SafePerformanceProfile)),
 		
 		
 		// === INTERNAL STATE ===
@@ -108,6 +108,8 @@ void ProjectSettingsWindow::loadSettings()
 	} else {
 		defaultHikerCombo->setCurrentIndex(0);
 	}
+	
+	performanceProfileCombo->setCurrentIndex(db.projectSettings.performanceProfile.get());
 }
 
 /**
@@ -129,6 +131,12 @@ void ProjectSettingsWindow::saveSettings()
 	else {
 		db.projectSettings.defaultHiker.set(*this, parseItemCombo(*defaultHikerCombo, selectableHikerIDs).asQVariant());
 	}
+	
+	const int newPerformanceProfile = performanceProfileCombo->currentIndex();
+	if (newPerformanceProfile != db.projectSettings.performanceProfile.get()) {
+		db.projectSettings.performanceProfile.set(*this, newPerformanceProfile);
+		db.applyPerformanceProfile(*this);
+	}
 }
 
 
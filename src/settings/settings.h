@@ -322,6 +322,8 @@ public:
 	
 	/** Only prepare the composite table corresponding to the open tab on startup, and defer preparing the other tables until they are opened. */
 	inline static const Setting<bool>			onlyPrepareActiveTableOnStartup				= Setting<bool>			("onlyPrepareActiveTableOnStartup",				true);
+	/** Only compute cells of columns which are not used for sorting or filtering when they are shown, instead of computing the whole column in advance. */
+	inline static const Setting<bool>			computeCellsOnDemand						= Setting<bool>			("computeCellsOnDemand",						true);
 	
 	// Remember UI
 	/** Remember the window positions of the main window and all dialogs. */
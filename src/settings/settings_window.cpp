@@ -136,6 +136,7 @@ void SettingsWindow::loadSettings()
 	warnAboutDuplicateNamesCheckbox				->setChecked	(warnAboutDuplicateNames					.get());
 	defaultNumericColumnsToDescendingCheckbox	->setChecked	(sortNumericColumnsDescendingByDefault		.get());
 	onlyPrepareActiveTableCheckbox				->setChecked	(onlyPrepareActiveTableOnStartup			.get());
+	computeCellsOnDemandCheckbox				->setChecked	(computeCellsOnDemand						.get());
 	rememberWindowGeometryCheckbox				->setChecked	(rememberWindowPositions					.get());
 	rememberWindowPositionsRelativeCheckbox		->setChecked	(rememberWindowPositionsRelative			.get());
 	rememberTableCheckbox						->setChecked	(rememberTab								.get());
@@ -191,6 +192,7 @@ void SettingsWindow::loadDefaults()
 	warnAboutDuplicateNamesCheckbox				->setChecked	(warnAboutDuplicateNames					.getDefault());
 	defaultNumericColumnsToDescendingCheckbox	->setChecked	(sortNumericColumnsDescendingByDefault		.getDefault());
 	onlyPrepareActiveTableCheckbox				->setChecked	(onlyPrepareActiveTableOnStartup			.getDefault());
+	computeCellsOnDemandCheckbox				->setChecked	(computeCellsOnDemand						.getDefault());
 	rememberWindowGeometryCheckbox				->setChecked	(rememberWindowPositions					.getDefault());
 	rememberWindowPositionsRelativeCheckbox		->setChecked	(rememberWindowPositionsRelative			.getDefault());
 	rememberTableCheckbox						->setChecked	(rememberTab								.getDefault());
@@ -260,6 +262,7 @@ void SettingsWindow::saveSettings()
 	warnAboutDuplicateNames						.set(warnAboutDuplicateNamesCheckbox			->isChecked());
 	sortNumericColumnsDescendingByDefault		.set(defaultNumericColumnsToDescendingCheckbox	->isChecked());
 	onlyPrepareActiveTableOnStartup				.set(onlyPrepareActiveTableCheckbox				->isChecked());
+	computeCellsOnDemand						.set(computeCellsOnDemandCheckbox				->isChecked());
 	rememberWindowPositions						.set(rememberWindowGeometryCheckbox				->isChecked());
 	rememberWindowPositionsRelative				.set(rememberWindowPositionsRelativeCheckbox	->isChecked());
 	rememberTab									.set(rememberTableCheckbox						->isChecked());
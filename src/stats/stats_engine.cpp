@@ -156,6 +156,7 @@ GeneralStatsEngine::GeneralStatsEngine(Database& db, QVBoxLayout** const statist
 	numAscentsPerYearChart(nullptr),
 	elevGainPerYearChart(nullptr),
 	heightsScatterChart(nullptr),
+	affectedChartsPerColumn(QHash<const Column*, QSet<Chart*>>()),
 	changeListener(TableChangeListenerGeneralStatsEngine(*this))
 {
 	assert(statisticsTabLayoutPtr);
@@ -205,6 +206,8 @@ void GeneralStatsEngine::setupStatsTab()
 	for (Chart* const chart : std::as_const(charts)) {
 		dirty[chart] = true;
 	}
+	
+	affectedChartsPerColumn = buildAffectedChartsPerColumn();
 }
 
 /**
@@ -373,11 +376,11 @@ QHash<Chart*, QSet<const Column*>> GeneralStatsEngine::getUsedColumnSets() const
 
 
 /**
- * Returns a map of columns and sets of charts affected by changes to each column.
+ * Builds a map of columns and sets of charts affected by changes to each column.
  * 
  * @return	A map of columns and sets of charts affected by changes to each column.
  */
-QHash<const Column*, QSet<Chart*>> GeneralStatsEngine::getAffectedChartsPerColumn() const
+QHash<const Column*, QSet<Chart*>> GeneralStatsEngine::buildAffectedChartsPerColumn() const
 {
 	auto usedColumnsPerChart = getUsedColumnSets();
 	QHash<const Column*, QSet<Chart*>> chartsPerColumn = QHash<const Column*, QSet<Chart*>>();
@@ -422,6 +425,10 @@ ItemStatsEngine::ItemStatsEngine(Database& db, PALItemType itemType, const Norma
 	topElevGainSumChart		(nullptr),
 	currentStartBufferRows	(QSet<BufferRowIndex>()),
 	currentlyAllRowsSelected(false),
+	breadcrumbsPerUnderlyingColumn	(QHash<const Column*, QSet<const Breadcrumbs*>>()),
+	chartsPerBreadcrumbs			(QHash<const Breadcrumbs*, QSet<Chart*>>()),
+	cachedChartsPerUnderlyingColumn	(QHash<const Column*, QSet<Chart*>>()),
+	labelChartsPerUnderlyingColumn	(QHash<const Column*, QSet<Chart*>>()),
 	ascentCrumbsSingleRowResultCache	(QMap<BufferRowIndex, QList<BufferRowIndex>>()),
 	ascentCrumbsWholeSetResultCache		(QHash<QSet<BufferRowIndex>, QList<BufferRowIndex>>()),
 	peakCrumbsSingleRowResultCache		(QMap<BufferRowIndex, QList<BufferRowIndex>>()),
@@ -507,6 +514,8 @@ void ItemStatsEngine::setupStatsPanel()
 	for (Chart* const chart : std::as_const(charts)) {
 		dirty[chart] = true;
 	}
+	
+	buildColumnDependencies();
 }
 
 /**
@@ -551,43 +560,33 @@ void ItemStatsEngine::resetStatsPanel()
  */
 void ItemStatsEngine::announceColumnChanges(const QSet<const Column*>& changedColumns)
 {
+	// Collect affected breadcrumbs and charts
+	QSet<const Breadcrumbs*> affectedBreadcrumbs = QSet<const Breadcrumbs*>();
+	QSet<Chart*> chartsToClear = QSet<Chart*>();
+	QSet<Chart*> chartsToRegenerate = QSet<Chart*>();
+	for (const Column* const column : changedColumns) {
+		affectedBreadcrumbs	.unite(breadcrumbsPerUnderlyingColumn	.value(column));
+		chartsToClear		.unite(cachedChartsPerUnderlyingColumn	.value(column));
+		chartsToRegenerate	.unite(labelChartsPerUnderlyingColumn	.value(column));
+	}
+	
 	// === LEVEL 1 ===
 	// Changes under breadcrumbs always require breadcrumb and derivative chart cache reset
-	const QHash<const Breadcrumbs*, QSet<Chart*>> breadcrumbDependencies = getBreadcrumbDependencyMap();
-	const QList<const Breadcrumbs*> allBreadcrumbs = breadcrumbDependencies.keys();
-	for (const Breadcrumbs* const breadcrumbs : allBreadcrumbs) {
-		if (!breadcrumbs->getColumnSet().intersects(changedColumns)) continue;
-		
+	for (const Breadcrumbs* const breadcrumbs : std::as_const(affectedBreadcrumbs)) {
 		clearBreadcrumbCachesFor(breadcrumbs);
-		
-		// Mark all dependent charts dirty and reset their caches
-		const QSet<Chart*> charts = breadcrumbDependencies.value(breadcrumbs);
-		for (Chart* const chart : charts) {
-			dirty[chart] = true;
-			clearChartCacheFor(*chart);
-		}
+		chartsToClear.unite(chartsPerBreadcrumbs.value(breadcrumbs));
 	}
 	
 	// === LEVEL 2 ===
 	// Changes under columns used for chart-specific caches require resetting those caches
-	const QHash<Chart*, QSet<const Column*>> columnsPerChart = getPostCrumbsUnderlyingColumnSetPerChart();
-	QList<Chart*> charts = columnsPerChart.keys();
-	for (Chart* const chart : std::as_const(charts)) {
-		const QSet<const Column*> columns = columnsPerChart.value(chart);
-		if (!columns.intersects(changedColumns)) continue;
-		
+	for (Chart* const chart : std::as_const(chartsToClear)) {
 		dirty[chart] = true;
 		clearChartCacheFor(*chart);
 	}
 	
 	// === LEVEL 3 ===
 	// Changes under columns used only for item labels only require chart regeneration without any cache resets (only relevant for top-n charts)
-	const QHash<Chart*, QSet<const Column*>> labelColumnsPerChart = getItemLabelUnderlyingColumnSetPerChart();
-	charts = labelColumnsPerChart.keys();
-	for (Chart* const chart : std::as_const(charts)) {
-		const QSet<const Column*> columns = labelColumnsPerChart.value(chart);
-		if (!columns.intersects(changedColumns)) continue;
-		
+	for (Chart* const chart : std::as_const(chartsToRegenerate)) {
 		dirty[chart] = true;
 	}
 }
@@ -887,22 +886,23 @@ QList<BufferRowIndex> ItemStatsEngine::evaluateCrumbsCached(const Breadcrumbs& c
 		return targetBufferRows;
 	}
 	
+	// Evaluate all rows missing from the cache together and write results to cache
+	QList<BufferRowIndex> uncachedBufferRows = QList<BufferRowIndex>();
 	for (const BufferRowIndex& currentBufferRow : selectedBufferRows) {
-		QList<BufferRowIndex> newTargetBufferRows;
-		
-		// Check cache
-		if (Q_LIKELY(crumbsSingleRowResultCache.contains(currentBufferRow))) {
-			// Cache hit
-			newTargetBufferRows = crumbsSingleRowResultCache.value(currentBufferRow);
+		if (Q_UNLIKELY(!crumbsSingleRowResultCache.contains(currentBufferRow))) {
+			uncachedBufferRows.append(currentBufferRow);
 		}
-		else {
-			// Cache miss
-			newTargetBufferRows = crumbs.evaluateForStats({ currentBufferRow });
-			// Write to cache
-			crumbsSingleRowResultCache.insert(currentBufferRow, newTargetBufferRows);
+	}
+	if (!uncachedBufferRows.isEmpty()) {
+		const BreadcrumbMapping mapping = crumbs.evaluateForRows(uncachedBufferRows, true);
+		for (int i = 0; i < uncachedBufferRows.size(); i++) {
+			crumbsSingleRowResultCache.insert(uncachedBufferRows.at(i), mapping.getTargetRowsFor(i));
 		}
-		
-		targetBufferRows.append(newTargetBufferRows);
+	}
+	
+	for (const BufferRowIndex& currentBufferRow : selectedBufferRows) {
+		assert(crumbsSingleRowResultCache.contains(currentBufferRow));
+		targetBufferRows.append(crumbsSingleRowResultCache.value(currentBufferRow));
 	}
 	
 	return targetBufferRows;
@@ -1028,23 +1028,26 @@ void ItemStatsEngine::updateTopNChart(TopNChart& chart, const Breadcrumbs& crumb
 	
 	QList<QPair<BufferRowIndex, qreal>> indexValuePairs = QList<QPair<BufferRowIndex, qreal>>();
 	
-	// Find the desired value for every selected buffer row in the start table
+	// Evaluate breadcrumbs for all selected buffer rows missing from the cache together
+	QList<BufferRowIndex> uncachedStartBufferRows = QList<BufferRowIndex>();
 	for (const BufferRowIndex& currentStartBufferIndex : selectedBufferRows) {
-		qreal valueForCurrentStartIndex;
-		
-		// Check cache
-		if (Q_LIKELY(cache.contains(currentStartBufferIndex))) {
-			// Cache hit
-			valueForCurrentStartIndex = cache.value(currentStartBufferIndex);
+		if (Q_UNLIKELY(!cache.contains(currentStartBufferIndex))) {
+			uncachedStartBufferRows.append(currentStartBufferIndex);
 		}
-		else {
-			// Cache miss
-			const QList<BufferRowIndex> currentTargetBufferRows = crumbs.evaluateForStats({currentStartBufferIndex});
-			valueForCurrentStartIndex = valueFromTargetBufferRows(currentTargetBufferRows);
-			
+	}
+	if (!uncachedStartBufferRows.isEmpty()) {
+		const BreadcrumbMapping mapping = crumbs.evaluateForRows(uncachedStartBufferRows, true);
+		for (int i = 0; i < uncachedStartBufferRows.size(); i++) {
+			const qreal value = valueFromTargetBufferRows(mapping.getTargetRowsFor(i));
 			// Write to cache
-			cache.insert(currentStartBufferIndex, valueForCurrentStartIndex);
+			cache.insert(uncachedStartBufferRows.at(i), value);
 		}
+	}
+	
+	// Find the desired value for every selected buffer row in the start table
+	for (const BufferRowIndex& currentStartBufferIndex : selectedBufferRows) {
+		assert(cache.contains(currentStartBufferIndex));
+		const qreal valueForCurrentStartIndex = cache.value(currentStartBufferIndex);
 		
 		if (Q_UNLIKELY(valueForCurrentStartIndex <= 0)) continue;
 		
@@ -1182,6 +1185,46 @@ void ItemStatsEngine::clearChartCacheFor(Chart& chart)
 }
 
 
+/**
+ * Builds the maps from database columns to the breadcrumbs and charts which depend on them, so
+ * that changes can be routed to the affected caches and charts directly.
+ * 
+ * To be called once the charts have been created.
+ */
+void ItemStatsEngine::buildColumnDependencies()
+{
+	breadcrumbsPerUnderlyingColumn.clear();
+	chartsPerBreadcrumbs.clear();
+	cachedChartsPerUnderlyingColumn.clear();
+	labelChartsPerUnderlyingColumn.clear();
+	
+	const QHash<const Breadcrumbs*, QSet<Chart*>> breadcrumbDependencies = getBreadcrumbDependencyMap();
+	for (auto iter = breadcrumbDependencies.constBegin(); iter != breadcrumbDependencies.constEnd(); iter++) {
+		const Breadcrumbs* const breadcrumbs = iter.key();
+		QSet<Chart*> dependentCharts = iter.value();
+		dependentCharts.remove(nullptr);
+		chartsPerBreadcrumbs.insert(breadcrumbs, dependentCharts);
+		
+		const QSet<const Column*> columns = breadcrumbs->getColumnSet();
+		for (const Column* const column : columns) {
+			breadcrumbsPerUnderlyingColumn[column].insert(breadcrumbs);
+		}
+	}
+	
+	const auto addChartsPerColumn = [] (const QHash<Chart*, QSet<const Column*>>& columnsPerChart, QHash<const Column*, QSet<Chart*>>& chartsPerColumn) {
+		for (auto iter = columnsPerChart.constBegin(); iter != columnsPerChart.constEnd(); iter++) {
+			Chart* const chart = iter.key();
+			if (!chart) continue;
+			const QSet<const Column*>& columns = iter.value();
+			for (const Column* const column : columns) {
+				chartsPerColumn[column].insert(chart);
+			}
+		}
+	};
+	addChartsPerColumn(getPostCrumbsUnderlyingColumnSetPerChart(),	cachedChartsPerUnderlyingColumn);
+	addChartsPerColumn(getItemLabelUnderlyingColumnSetPerChart(),	labelChartsPerUnderlyingColumn);
+}
+
 /**
  * Returns a map of breadcrumbs pointers and the sets of charts affected by changes to each
  * breadcrumbs trail.
@@ -91,6 +91,9 @@ class GeneralStatsEngine : public StatsEngine
 	/** A chart showing elevation gain and peak height for every logged ascent. */
 	TimeScatterChart*	heightsScatterChart;
 	
+	/** For each database column, the charts affected by changes to it. Built once the charts are set up. */
+	QHash<const Column*, QSet<Chart*>> affectedChartsPerColumn;
+	
 	/** The change listener registered with the database to receive change notifications. */
 	TableChangeListenerGeneralStatsEngine changeListener;
 	
@@ -107,7 +110,7 @@ public:
 protected:
 	QHash<Chart*, QSet<const Column*>> getUsedColumnSets() const;
 private:
-	QHash<const Column*, QSet<Chart*>> getAffectedChartsPerColumn() const;
+	QHash<const Column*, QSet<Chart*>> buildAffectedChartsPerColumn() const;
 	
 	friend class TableChangeListenerGeneralStatsEngine;
 };
@@ -163,6 +166,16 @@ class ItemStatsEngine : public StatsEngine
 	/** Whether the current set of buffer rows is the complete set of buffer rows currently displayed in the table. */
 	bool currentlyAllRowsSelected;
 	
+	// Column dependencies, built once the charts are set up
+	/** For each database column, the breadcrumbs whose caches have to be reset when it changes. */
+	QHash<const Column*, QSet<const Breadcrumbs*>>	breadcrumbsPerUnderlyingColumn;
+	/** For each breadcrumb trail, the charts which depend on it. */
+	QHash<const Breadcrumbs*, QSet<Chart*>>			chartsPerBreadcrumbs;
+	/** For each database column, the charts whose caches have to be reset when it changes. */
+	QHash<const Column*, QSet<Chart*>>				cachedChartsPerUnderlyingColumn;
+	/** For each database column, the charts which only have to be regenerated when it changes because it is used for item labels. */
+	QHash<const Column*, QSet<Chart*>>				labelChartsPerUnderlyingColumn;
+	
 	// Caching
 	// Breadcrumb caches
 	/** A cache which holds the results of evaluating the ascent crumbs for individual base table buffer rows. */
@@ -213,6 +226,7 @@ private:
 	void clearBreadcrumbCachesFor(const Breadcrumbs* const breadcrumbs);
 	void clearChartCacheFor(Chart& chart);
 	
+	void buildColumnDependencies();
 	QHash<const Breadcrumbs*, QSet<Chart*>> getBreadcrumbDependencyMap() const;
 	QHash<Chart*, QSet<const Column*>> getPostCrumbsUnderlyingColumnSetPerChart() const;
 	QSet<const Column*> getItemLabelUnderlyingColumnSet() const;
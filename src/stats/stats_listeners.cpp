@@ -51,17 +51,18 @@ TableChangeListenerGeneralStatsEngine::~TableChangeListenerGeneralStatsEngine()
  *
  * @param affectedColumns				The columns whose data has been changed.
  * @param rowsAddedOrRemovedPerTable	The rows that have been added or removed from the table. The bool indicates whether the row was added (true) or removed (false).
+ * @param changedRowsPerColumn			The rows in which existing cells have been changed, for each affected column.
  */
-void TableChangeListenerGeneralStatsEngine::dataChanged(const QSet<const Column*>& affectedColumns, const QHash<const Table*, QList<QPair<BufferRowIndex, bool>>>& rowsAddedOrRemovedPerTable) const
+void TableChangeListenerGeneralStatsEngine::dataChanged(const QSet<const Column*>& affectedColumns, const QHash<const Table*, QList<QPair<BufferRowIndex, bool>>>& rowsAddedOrRemovedPerTable, const QHash<const Column*, QSet<BufferRowIndex>>& changedRowsPerColumn) const
 {
 	Q_UNUSED(rowsAddedOrRemovedPerTable);
+	Q_UNUSED(changedRowsPerColumn);
 	
 	if (affectedColumns.isEmpty()) return;
 	
-	const QHash<const Column*, QSet<Chart*>> chartsPerColumn = owner.getAffectedChartsPerColumn();
 	for (const Column* column : affectedColumns) {
-		if (chartsPerColumn.contains(column)) {
-			owner.markChartsDirty(chartsPerColumn.value(column));
+		if (owner.affectedChartsPerColumn.contains(column)) {
+			owner.markChartsDirty(owner.affectedChartsPerColumn.value(column));
 		}
 	}
 }
@@ -93,10 +94,12 @@ TableChangeListenerItemStatsEngine::~TableChangeListenerItemStatsEngine()
  *
  * @param affectedColumns				The columns whose data has been changed.
  * @param rowsAddedOrRemovedPerTable	The rows that have been added or removed from the table. The bool indicates whether the row was added (true) or removed (false).
+ * @param changedRowsPerColumn			The rows in which existing cells have been changed, for each affected column.
  */
-void TableChangeListenerItemStatsEngine::dataChanged(const QSet<const Column*>& affectedColumns, const QHash<const Table*, QList<QPair<BufferRowIndex, bool>>>& rowsAddedOrRemovedPerTable) const
+void TableChangeListenerItemStatsEngine::dataChanged(const QSet<const Column*>& affectedColumns, const QHash<const Table*, QList<QPair<BufferRowIndex, bool>>>& rowsAddedOrRemovedPerTable, const QHash<const Column*, QSet<BufferRowIndex>>& changedRowsPerColumn) const
 {
 	Q_UNUSED(rowsAddedOrRemovedPerTable);
+	Q_UNUSED(changedRowsPerColumn);
 	
 	if (affectedColumns.isEmpty()) return;
 	
@@ -44,7 +44,7 @@ public:
 	TableChangeListenerGeneralStatsEngine(GeneralStatsEngine& owner);
 	virtual ~TableChangeListenerGeneralStatsEngine();
 	
-	virtual void dataChanged(const QSet<const Column*>& affectedColumns, const QHash<const Table*, QList<QPair<BufferRowIndex, bool>>>& rowsAddedOrRemovedPerTable) const;
+	virtual void dataChanged(const QSet<const Column*>& affectedColumns, const QHash<const Table*, QList<QPair<BufferRowIndex, bool>>>& rowsAddedOrRemovedPerTable, const QHash<const Column*, QSet<BufferRowIndex>>& changedRowsPerColumn) const;
 };
 
 
@@ -60,7 +60,7 @@ public:
 	TableChangeListenerItemStatsEngine(ItemStatsEngine& owner);
 	virtual ~TableChangeListenerItemStatsEngine();
 	
-	virtual void dataChanged(const QSet<const Column*>& affectedColumns, const QHash<const Table*, QList<QPair<BufferRowIndex, bool>>>& rowsAddedOrRemovedPerTable) const;
+	virtual void dataChanged(const QSet<const Column*>& affectedColumns, const QHash<const Table*, QList<QPair<BufferRowIndex, bool>>>& rowsAddedOrRemovedPerTable, const QHash<const Column*, QSet<BufferRowIndex>>& changedRowsPerColumn) const;
 };
 
 
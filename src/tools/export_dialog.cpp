@@ -143,6 +143,11 @@ void DataExportDialog::handle_start()
 	ExportFormat fileFormat		= getCurrentlySelectedFileFormat();
 	const QString& csvSeparator	= getCurrentlySelectedCsvSeparator();
 	
+	// Background updates write to the composite buffers on this thread, so let them finish first
+	for (ItemTypeMapper* const mapper : typesHandler.getAllMappers()) {
+		mapper->compTable.waitForBackgroundUpdate();
+	}
+	
 	workerThread = new DataExportThread(*this, typesHandler, mode, includeStats, filepathLineEdit->text(), fileFormat, csvSeparator);
 	
 	connect(workerThread, &DataExportThread::callback_reportWorkloadSize,	this,	&DataExportDialog::handle_callback_workloadSize);
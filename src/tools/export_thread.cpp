@@ -139,18 +139,19 @@ void DataExportThread::exportOneTable()
 	
 	// Determine and report workload size
 	int workloadSize = 0;	// In cells
-	workloadSize += compTable.getNumberOfCellsToUpdate();
+	const int numDirtyCells = compTable.getNumberOfDirtyCellsFromWorkerThread();
+	workloadSize += numDirtyCells;
 	workloadSize += compTable.rowCount() * allColumnInfos.at(0).size();
 	emit callback_reportWorkloadSize(workloadSize);
 	int progress = 0;
 	
 	// Make sure table is up to date
-	if (compTable.getNumberOfCellsToUpdate() >= 1) {
+	if (numDirtyCells >= 1) {
 		emit callback_setProgressText(tr("Preparing table..."));
 		auto progressLambda = [this, &progress] () {
 			emit callback_reportProgress(++progress);
 		};
-		compTable.updateBothBuffers(progressLambda);
+		compTable.updateAllColumnsFromWorkerThread(progressLambda);
 	}
 	
 	
@@ -220,24 +221,27 @@ void DataExportThread::exportAsShown()
 	
 	// Determine and report workload size
 	int workloadSize = 0;	// In cells
+	QList<int> numDirtyCellsPerTable = QList<int>();
 	for (int tableIndex = 0; tableIndex < compTables.size(); tableIndex++) {
-		const CompositeTable& compTable = *compTables.at(tableIndex);
-		workloadSize += compTable.getNumberOfCellsToUpdate();
+		CompositeTable& compTable = *compTables.at(tableIndex);
+		numDirtyCellsPerTable.append(compTable.getNumberOfDirtyCellsFromWorkerThread());
+		workloadSize += numDirtyCellsPerTable.last();
 		workloadSize += compTable.rowCount() * allColumnInfos.at(tableIndex).size();
 	}
 	emit callback_reportWorkloadSize(workloadSize);
 	int progress = 0;
 	
 	// Make sure all tables are up to date
-	for (CompositeTable* const compTable : std::as_const(compTables)) {
+	for (int tableIndex = 0; tableIndex < compTables.size(); tableIndex++) {
 		if (abortWasCalled) break;
-		if (compTable->getNumberOfCellsToUpdate() < 1) continue;
+		if (numDirtyCellsPerTable.at(tableIndex) < 1) continue;
+		CompositeTable* const compTable = compTables.at(tableIndex);
 		
 		emit callback_setProgressText(tr("Preparing table %1...").arg(compTable->uiName));
 		auto progressLambda = [this, &progress] () {
 			emit callback_reportProgress(++progress);
 		};
-		compTable->updateBothBuffers(progressLambda);
+		compTable->updateAllColumnsFromWorkerThread(progressLambda);
 	}
 	
 	if (abortWasCalled) return;